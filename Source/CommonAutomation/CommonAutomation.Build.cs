@@ -7,6 +7,8 @@ public class CommonAutomation : ModuleRules
 	public CommonAutomation(ReadOnlyTargetRules Target) : base(Target)
 	{
 		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		// required for FWorldTask coroutines
+		CppStandard = CppStandardVersion.Cpp20;
 		
 		PrivateDefinitions.AddRange(
 			new string []
@@ -27,6 +29,7 @@ public class CommonAutomation : ModuleRules
 			new string[]
 			{
 				"Engine",
+				"RenderCore",
 				"Slate",
 				"SlateCore",
 				"NavigationSystem",
@@ -34,11 +37,23 @@ public class CommonAutomation : ModuleRules
 				"DeveloperSettings",
 				"CommonAutomationRuntime",
 				"AssetRegistry", 
-				"GameProjectGeneration",
-				"UnrealEd",
+				"Projects",
 				"StructUtils",
+				"Json",
 			}
 		);
+
+		if (Target.bBuildEditor)
+		{
+			PrivateDependencyModuleNames.AddRange(
+				new string[]
+				{
+					"DataLayerEditor",
+					"GameProjectGeneration",
+					"UnrealEd",
+				}
+			);
+		}
 		
 		if (Target.Version.MinorVersion >= 5)
 		{
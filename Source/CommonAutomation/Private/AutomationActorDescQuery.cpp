@@ -0,0 +1,118 @@
+#include "AutomationActorDescQuery.h"
+
+#include "CommonAutomationModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/Level.h"
+
+#if WITH_EDITOR
+#include "WorldPartition/WorldPartitionActorDesc.h"
+#include "WorldPartition/WorldPartitionActorDescUtils.h"
+#endif
+
+bool UE::Automation::FActorDescFilter::Matches(const FActorDescInfo& ActorDesc, const UClass* NativeClass) const
+{
+	if (!Classes.IsEmpty())
+	{
+		if (NativeClass == nullptr || !Classes.ContainsByPredicate([NativeClass](const UClass* Class) { return NativeClass->IsChildOf(Class); }))
+		{
+			return false;
+		}
+	}
+
+	if (Bounds.IsSet() && !Bounds->Intersect(ActorDesc.Bounds))
+	{
+		return false;
+	}
+
+	if (!DataLayers.IsEmpty() && !DataLayers.ContainsByPredicate([&ActorDesc](const FName DataLayer) { return ActorDesc.DataLayers.Contains(DataLayer); }))
+	{
+		return false;
+	}
+
+	if (!Tags.IsEmpty() && !Tags.ContainsByPredicate([&ActorDesc](const FName Tag) { return ActorDesc.Tags.Contains(Tag); }))
+	{
+		return false;
+	}
+
+	return Label.IsEmpty() || ActorDesc.Label.ToString().Contains(Label);
+}
+
+int32 UE::Automation::FActorDescQuery::ForEach(FName MapPackage, const FActorDescFilter& Filter, TFunctionRef<bool(const FActorDescInfo&)> Func)
+{
+#if WITH_EDITOR
+	TRACE_CPUPROFILER_EVENT_SCOPE(FActorDescQuery_ForEach);
+
+	// external actors of a map are stored under __ExternalActors__ folder mirroring map package path
+	FARFilter AssetFilter;
+	AssetFilter.PackagePaths.Add(FName{ULevel::GetExternalActorsPath(MapPackage.ToString())});
+	AssetFilter.bRecursivePaths = true;
+	AssetFilter.bIncludeOnlyOnDiskAssets = true;
+
+	int32 NumMatched = 0;
+	IAssetRegistry::GetChecked().EnumerateAssets(AssetFilter, [&Filter, &Func, &NumMatched](const FAssetData& AssetData)
+	{
+		if (!FWorldPartitionActorDescUtils::IsValidActorDescriptorFromAssetData(AssetData))
+		{
+			return true;
+		}
+
+		const TUniquePtr<FWorldPartitionActorDesc> ActorDesc = FWorldPartitionActorDescUtils::GetActorDescriptorFromAssetData(AssetData);
+		if (!ActorDesc.IsValid())
+		{
+			return true;
+		}
+
+		FActorDescInfo Info;
+		Info.Guid = ActorDesc->GetGuid();
+		Info.NativeClass = ActorDesc->GetNativeClass();
+		Info.BaseClass = ActorDesc->GetBaseClass().IsValid() ? ActorDesc->GetBaseClass() : ActorDesc->GetNativeClass();
+		Info.Label = ActorDesc->GetActorLabel();
+		Info.ActorPackage = ActorDesc->GetActorPackage();
+		Info.ActorPath = ActorDesc->GetActorSoftPath();
+		Info.Bounds = ActorDesc->GetEditorBounds();
+		Info.bIsSpatiallyLoaded = ActorDesc->GetIsSpatiallyLoaded();
+		for (const FName DataLayer: ActorDesc->GetDataLayerInstanceNames())
+		{
+			Info.DataLayers.Add(DataLayer);
+		}
+		for (const FName DataLayer: ActorDesc->GetDataLayers())
+		{
+			// data layer assets are referenced by path, data layers set up without assets by instance name
+			const FNameBuilder DataLayerName{DataLayer};
+			const FName DataLayerAssetName = DataLayerName.ToView().StartsWith(TEXT('/')) ? FName{FSoftObjectPath{DataLayerName.ToView()}.GetAssetName()} : DataLayer;
+			Info.DataLayers.AddUnique(DataLayerAssetName);
+		}
+		Info.Tags = ActorDesc->GetTags();
+
+		if (!Filter.Matches(Info, ActorDesc->GetActorNativeClass()))
+		{
+			return true;
+		}
+
+		++NumMatched;
+		return Func(Info);
+	});
+
+	return NumMatched;
+#else
+	UE_LOG(LogCommonAutomation, Error, TEXT("%s: Actor descriptors are not available in non-editor builds"), *FString(__FUNCTION__));
+	return 0;
+#endif
+}
+
+TArray<UE::Automation::FActorDescInfo> UE::Automation::FActorDescQuery::Find(FName MapPackage, const FActorDescFilter& Filter)
+{
+	TArray<FActorDescInfo> Result;
+	ForEach(MapPackage, Filter, [&Result](const FActorDescInfo& Info)
+	{
+		Result.Add(Info);
+		return true;
+	});
+
+	return Result;
+}
+
+int32 UE::Automation::FActorDescQuery::Count(FName MapPackage, const FActorDescFilter& Filter)
+{
+	return ForEach(MapPackage, Filter, [](const FActorDescInfo& Info) { return true; });
+}
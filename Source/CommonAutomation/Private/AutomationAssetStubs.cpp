@@ -0,0 +1,161 @@
+#include "AutomationAssetStubs.h"
+
+#include "CommonAutomationModule.h"
+#include "CommonAutomationSettings.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/StaticMesh.h"
+#include "Misc/PackageName.h"
+#include "UObject/LinkerInstancingContext.h"
+#include "UObject/Package.h"
+
+UE::Automation::FAssetStubs::FAssetStubs(TConstArrayView<UClass*> InStubClasses, bool bInKeepCollisionMeshes)
+	: StubClasses(InStubClasses)
+	, bKeepCollisionMeshes(bInKeepCollisionMeshes)
+{
+}
+
+int32 UE::Automation::FAssetStubs::AddStubs(FName PackageName, FLinkerInstancingContext& InstancingContext)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAssetStubs_AddStubs);
+	if (StubClasses.IsEmpty())
+	{
+		return 0;
+	}
+
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	const int32 NumStubbedPackages = StubbedPackages.Num();
+
+	// instancing context remaps imports of the world package only, so only its direct dependencies can be stubbed
+	TArray<FName> WorldDependencies;
+	AssetRegistry.GetDependencies(PackageName, WorldDependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+
+	TSet<FName> Candidates;
+	TArray<FAssetData> Assets;
+	for (const FName Dependency: WorldDependencies)
+	{
+		// stubbing an asset that is already loaded saves nothing
+		if (FPackageName::IsScriptPackage(FNameBuilder{Dependency}) || FindObjectFast<UPackage>(nullptr, Dependency) != nullptr)
+		{
+			continue;
+		}
+		
+		Assets.Reset();
+		AssetRegistry.GetAssetsByPackageName(Dependency, Assets);
+		// stub replaces the whole package, so only single asset packages are substituted
+		if (Assets.Num() == 1 && ShouldStub(Assets[0]))
+		{
+			Candidates.Add(Dependency);
+		}
+	}
+
+	// packages loaded by the world are loaded without instancing context. Candidate they import is loaded as well and can't be stubbed
+	TSet<FName> VisitedPackages{PackageName};
+	TArray<FName> PackagesToVisit;
+	for (const FName Dependency: WorldDependencies)
+	{
+		if (!Candidates.Contains(Dependency))
+		{
+			VisitedPackages.Add(Dependency);
+			PackagesToVisit.Add(Dependency);
+		}
+	}
+	
+	TArray<FName> Dependencies;
+	while (!PackagesToVisit.IsEmpty() && !Candidates.IsEmpty())
+	{
+		Dependencies.Reset();
+		AssetRegistry.GetDependencies(PackagesToVisit.Pop(), Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+
+		for (const FName Dependency: Dependencies)
+		{
+			bool bAlreadyVisited = false;
+			VisitedPackages.Add(Dependency, &bAlreadyVisited);
+			if (bAlreadyVisited || FPackageName::IsScriptPackage(FNameBuilder{Dependency}))
+			{
+				continue;
+			}
+
+			Candidates.Remove(Dependency);
+			PackagesToVisit.Add(Dependency);
+		}
+	}
+
+	for (const FName Dependency: Candidates)
+	{
+		Assets.Reset();
+		AssetRegistry.GetAssetsByPackageName(Dependency, Assets);
+		UPackage* StubPackage = CreateStub(Assets[0], FindObject<UClass>(Assets[0].AssetClassPath));
+		InstancingContext.AddPackageMapping(Dependency, StubPackage->GetFName());
+		StubbedPackages.Add(Dependency);
+	}
+
+	const int32 NumStubs = StubbedPackages.Num() - NumStubbedPackages;
+	UE_LOG(LogCommonAutomation, Log, TEXT("%s: Replaced %d packages with stubs, visited %d dependencies of %s"), *FString(__FUNCTION__), NumStubs, VisitedPackages.Num() - 1, *PackageName.ToString());
+
+	return NumStubs;
+}
+
+bool UE::Automation::FAssetStubs::ShouldStub(const FAssetData& AssetData) const
+{
+	// asset class should be loaded already if any of stub classes is its parent
+	const UClass* AssetClass = FindObject<UClass>(AssetData.AssetClassPath);
+	if (AssetClass == nullptr)
+	{
+		return false;
+	}
+
+	if (bKeepCollisionMeshes && AssetClass->IsChildOf<UStaticMesh>())
+	{
+		// static mesh stub has no body setup, components using it wouldn't block traces or simulate
+		return false;
+	}
+
+	for (const UClass* StubClass: StubClasses)
+	{
+		if (AssetClass->IsChildOf(StubClass))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+FName UE::Automation::FAssetStubs::GetStubPackageName(FName PackageName)
+{
+	return FName{WriteToString<256>(TEXT("/Temp/AutomationStubs"), PackageName)};
+}
+
+TArray<UClass*> UE::Automation::FAssetStubs::GetDefaultStubClasses()
+{
+	TArray<UClass*> Classes;
+	for (const FSoftClassPath& ClassPath: UCommonAutomationSettings::Get()->StubAssetClasses)
+	{
+		// classes from modules that aren't loaded can't be referenced by loaded assets
+		if (UClass* Class = ClassPath.ResolveClass())
+		{
+			Classes.Add(Class);
+		}
+	}
+
+	return Classes;
+}
+
+UPackage* UE::Automation::FAssetStubs::CreateStub(const FAssetData& AssetData, UClass* AssetClass)
+{
+	check(AssetClass);
+
+	const FName StubPackageName = GetStubPackageName(AssetData.PackageName);
+	// stub package may be left from a previous world if garbage wasn't collected since
+	UPackage* StubPackage = CreatePackage(*StubPackageName.ToString());
+	if (FindObjectFast<UObject>(StubPackage, AssetData.AssetName) == nullptr)
+	{
+		StubPackage->SetFlags(RF_Transient);
+		// stub keeps original asset name, so that imports of the original asset resolve to it
+		NewObject<UObject>(StubPackage, AssetClass, AssetData.AssetName, RF_Public | RF_Transient);
+		StubPackage->MarkAsFullyLoaded();
+	}
+
+	StubPackages.Emplace(StubPackage);
+	return StubPackage;
+}
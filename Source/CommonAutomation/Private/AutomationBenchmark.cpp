@@ -0,0 +1,234 @@
+#include "AutomationBenchmark.h"
+
+#include "AutomationCommon.h"
+#include "Algo/Sort.h"
+#include "Dom/JsonObject.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace UE::Automation
+{
+	/** @return nearest rank percentile from sorted samples */
+	double GetSortedPercentile(TConstArrayView<double> SortedSamples, double Percentile)
+	{
+		check(!SortedSamples.IsEmpty());
+		const int32 Rank = FMath::CeilToInt32(Percentile * SortedSamples.Num()) - 1;
+		return SortedSamples[FMath::Clamp(Rank, 0, SortedSamples.Num() - 1)];
+	}
+
+	double GetSortedMedian(TConstArrayView<double> SortedSamples)
+	{
+		check(!SortedSamples.IsEmpty());
+		const int32 Num = SortedSamples.Num();
+		return Num % 2 == 1 ? SortedSamples[Num / 2] : 0.5 * (SortedSamples[Num / 2 - 1] + SortedSamples[Num / 2]);
+	}
+
+	TSharedRef<FJsonObject> StatsToJson(const FBenchmarkStats& Stats)
+	{
+		TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+		Json->SetNumberField(TEXT("min"), Stats.Min);
+		Json->SetNumberField(TEXT("max"), Stats.Max);
+		Json->SetNumberField(TEXT("median"), Stats.Median);
+		Json->SetNumberField(TEXT("p95"), Stats.P95);
+		Json->SetNumberField(TEXT("mean"), Stats.Mean);
+		Json->SetNumberField(TEXT("stddev"), Stats.StdDev);
+		Json->SetNumberField(TEXT("samples"), Stats.NumSamples);
+		Json->SetNumberField(TEXT("outliers"), Stats.NumOutliers);
+		
+		return Json;
+	}
+}
+
+UE::Automation::FBenchmarkStats UE::Automation::ComputeBenchmarkStats(TConstArrayView<double> Samples, double OutlierThreshold)
+{
+	FBenchmarkStats Stats{};
+	if (Samples.IsEmpty())
+	{
+		return Stats;
+	}
+
+	TArray<double> Sorted{Samples};
+	Algo::Sort(Sorted);
+
+	if (OutlierThreshold > 0.0 && Sorted.Num() > 2)
+	{
+		// median absolute deviation, scaled to be consistent with standard deviation for normal distribution
+		const double Median = GetSortedMedian(Sorted);
+		
+		TArray<double> Deviations;
+		Deviations.Reserve(Sorted.Num());
+		for (double Sample: Sorted)
+		{
+			Deviations.Add(FMath::Abs(Sample - Median));
+		}
+		Algo::Sort(Deviations);
+		
+		const double ScaledMAD = 1.4826 * GetSortedMedian(Deviations);
+		if (ScaledMAD > 0.0)
+		{
+			const int32 NumSamples = Sorted.Num();
+			Sorted.RemoveAll([Median, Limit = OutlierThreshold * ScaledMAD](double Sample)
+			{
+				return FMath::Abs(Sample - Median) > Limit;
+			});
+			Stats.NumOutliers = NumSamples - Sorted.Num();
+		}
+	}
+
+	Stats.NumSamples = Sorted.Num();
+	Stats.Min = Sorted[0];
+	Stats.Max = Sorted.Last();
+	Stats.Median = GetSortedMedian(Sorted);
+	Stats.P95 = GetSortedPercentile(Sorted, 0.95);
+
+	double Sum = 0.0;
+	for (double Sample: Sorted)
+	{
+		Sum += Sample;
+	}
+	Stats.Mean = Sum / Sorted.Num();
+
+	double SquaredSum = 0.0;
+	for (double Sample: Sorted)
+	{
+		SquaredSum += FMath::Square(Sample - Stats.Mean);
+	}
+	Stats.StdDev = Sorted.Num() > 1 ? FMath::Sqrt(SquaredSum / (Sorted.Num() - 1)) : 0.0;
+
+	return Stats;
+}
+
+void FAutomationBenchmarkBase::EnsureDefined() const
+{
+	if (!bDefined)
+	{
+		bDefined = true;
+		const_cast<FAutomationBenchmarkBase*>(this)->Define();
+	}
+}
+
+void FAutomationBenchmarkBase::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	EnsureDefined();
+
+	if (Config.SweepParams.IsEmpty())
+	{
+		OutBeautifiedNames.Add(TEXT("Default"));
+		OutTestCommands.Add(FString{});
+		return;
+	}
+	
+	for (const FString& Param: Config.SweepParams)
+	{
+		OutBeautifiedNames.Add(Param);
+		OutTestCommands.Add(Param);
+	}
+}
+
+bool FAutomationBenchmarkBase::RunTest(const FString& Parameters)
+{
+	EnsureDefined();
+	
+	if (!Config.Body)
+	{
+		AddError(TEXT("Benchmark body is not set"));
+		return false;
+	}
+
+	if (Config.NumRepetitions <= 0)
+	{
+		AddError(TEXT("Benchmark requires at least one repetition"));
+		return false;
+	}
+	
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationBenchmarkBase_RunTest);
+
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateWorld(Config.WorldParams.Get(FAutomationWorldInitParams::Minimal));
+	if (!ScopedWorld.IsValid())
+	{
+		AddError(TEXT("Failed to create automation world for benchmark"));
+		return false;
+	}
+
+	auto RunIteration = [this, &ScopedWorld, &Parameters](double& OutSeconds)
+	{
+		if (Config.BeforeIteration)
+		{
+			Config.BeforeIteration(*ScopedWorld, Parameters);
+		}
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Config.Body(*ScopedWorld, Parameters);
+		OutSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+		if (Config.AfterIteration)
+		{
+			Config.AfterIteration(*ScopedWorld, Parameters);
+		}
+	};
+
+	double Seconds = 0.0;
+	for (int32 Index = 0; Index < Config.NumWarmup; ++Index)
+	{
+		RunIteration(Seconds);
+	}
+
+	TArray<double> WallTimeSamples;
+	WallTimeSamples.Reserve(Config.NumRepetitions);
+	
+	for (int32 Index = 0; Index < Config.NumRepetitions; ++Index)
+	{
+		RunIteration(Seconds);
+		// wall time is reported in milliseconds
+		WallTimeSamples.Add(Seconds * 1000.0);
+	}
+
+	ReportResults(Parameters, UE::Automation::ComputeBenchmarkStats(WallTimeSamples, Config.OutlierThreshold));
+	
+	return !HasAnyErrors();
+}
+
+void FAutomationBenchmarkBase::ReportResults(const FString& Parameter, const UE::Automation::FBenchmarkStats& WallTime)
+{
+	auto AddStatsTelemetry = [this, &Parameter](const FString& Prefix, const UE::Automation::FBenchmarkStats& Stats)
+	{
+		AddTelemetryData(Prefix + TEXT(".Min"),		Stats.Min,		Parameter);
+		AddTelemetryData(Prefix + TEXT(".Median"),	Stats.Median,	Parameter);
+		AddTelemetryData(Prefix + TEXT(".P95"),		Stats.P95,		Parameter);
+		AddTelemetryData(Prefix + TEXT(".StdDev"),	Stats.StdDev,	Parameter);
+		AddTelemetryData(Prefix + TEXT(".Outliers"),	Stats.NumOutliers, Parameter);
+	};
+
+	AddStatsTelemetry(TEXT("WallTimeMs"), WallTime);
+
+	TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetStringField(TEXT("test"), GetBeautifiedTestName());
+	Json->SetStringField(TEXT("parameter"), Parameter);
+	Json->SetNumberField(TEXT("warmup"), Config.NumWarmup);
+	Json->SetNumberField(TEXT("repetitions"), Config.NumRepetitions);
+	Json->SetNumberField(TEXT("outlierThreshold"), Config.OutlierThreshold);
+	Json->SetObjectField(TEXT("wallTimeMs"), UE::Automation::StatsToJson(WallTime));
+
+	FString Output;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	FJsonSerializer::Serialize(Json, Writer);
+
+	const FString ArtifactPath = GetArtifactPath(Parameter);
+	if (!FFileHelper::SaveStringToFile(Output, *ArtifactPath))
+	{
+		AddWarning(FString::Printf(TEXT("Failed to write benchmark artifact %s"), *ArtifactPath));
+		return;
+	}
+
+	// analytics items are stored with test results, so CI can pick up results without knowing artifact location
+	AddAnalyticsItem(Output);
+	AddInfo(FString::Printf(TEXT("Benchmark results written to %s"), *ArtifactPath));
+}
+
+FString FAutomationBenchmarkBase::GetArtifactPath(const FString& Parameter) const
+{
+	const FString ArtifactName = FPaths::MakeValidFileName(Parameter.IsEmpty() ? GetBeautifiedTestName() : GetBeautifiedTestName() + TEXT("_") + Parameter, TEXT('_'));
+	return FPaths::ProjectSavedDir() / TEXT("Automation") / TEXT("Benchmarks") / ArtifactName + TEXT(".json");
+}
@@ -5,6 +5,8 @@
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetRegistry/IAssetRegistry.h"
 #include "EngineUtils.h"
+#include "AI/NavigationSystemBase.h"
+#include "Components/ActorComponent.h"
 
 DEFINE_LOG_CATEGORY(LogCommonAutomation);
 
@@ -85,6 +87,21 @@ FSoftObjectPath UE::Automation::FindWorldAssetByName(const FString& AssetName)
 	return FindAssetDataByName(AssetName, EPackageFlags::PKG_ContainsMap, UWorld::StaticClass()).ToSoftObjectPath();
 }
 
+void UE::Automation::RegisterActorComponents(UWorld* World, TConstArrayView<UActorComponent*> Components)
+{
+	check(World != nullptr);
+	TRACE_CPUPROFILER_EVENT_SCOPE(UE_Automation_RegisterActorComponents);
+
+	FNavigationLockContext NavigationLock{World, ENavigationLockReason::Unknown};
+	// primitives are added to the scene in a batch when context is processed
+	FRegisterComponentContext Context{World};
+	for (UActorComponent* Component: Components)
+	{
+		Component->RegisterComponentWithWorld(World, &Context);
+	}
+	Context.Process();
+}
+
 AAutomationTargetPoint* UE::Automation::FindTargetPoint(const UWorld* World, FName Label)
 {
 	for (TActorIterator<AAutomationTargetPoint> It{World}; It; ++It)
@@ -0,0 +1,235 @@
+#include "AutomationFrameTiming.h"
+
+#include "Algo/Sort.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+struct UE::Automation::FFrameTimingRecorder::FTickGroupSentinel: public FTickFunction
+{
+	FTickGroupSentinel(FFrameTimingRecorder& InRecorder, ETickingGroup InTickGroup)
+		: Recorder(&InRecorder)
+	{
+		TickGroup = InTickGroup;
+		EndTickGroup = InTickGroup;
+		// run before other tick functions of the same group
+		bHighPriority = true;
+		bTickEvenWhenPaused = true;
+		bCanEverTick = true;
+		bStartWithTickEnabled = true;
+	}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override
+	{
+		Recorder->TickGroupStartCycles[TickGroup] = FPlatformTime::Cycles64();
+	}
+
+	virtual FString DiagnosticMessage() override
+	{
+		return FString::Printf(TEXT("[FrameTiming] %s sentinel"), *UEnum::GetValueAsString(TickGroup.GetValue()));
+	}
+
+	FFrameTimingRecorder* Recorder = nullptr;
+};
+
+UE::Automation::FFrameTimingRecorder::FFrameTimingRecorder(int32 InCapacity)
+	: Capacity(FMath::Max(InCapacity, 1))
+{
+	Frames.Reserve(Capacity);
+	FMemory::Memzero(TickGroupStartCycles);
+
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddRaw(this, &FFrameTimingRecorder::HandlePreGarbageCollect);
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddRaw(this, &FFrameTimingRecorder::HandlePostGarbageCollect);
+}
+
+UE::Automation::FFrameTimingRecorder::~FFrameTimingRecorder()
+{
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+	UnregisterSentinels();
+}
+
+void UE::Automation::FFrameTimingRecorder::BeginFrame(UWorld* InWorld)
+{
+	GarbageCollectionCycles = 0;
+	FMemory::Memzero(TickGroupStartCycles);
+
+	if (HitchThresholdMs > 0.0 && SentinelWorld != InWorld)
+	{
+		UnregisterSentinels();
+		RegisterSentinels(InWorld);
+	}
+}
+
+void UE::Automation::FFrameTimingRecorder::EndFrame(const FFrameTiming& InTiming, uint64 WorldTickEndCycles, const FTickProfiler* TickProfiler)
+{
+	FFrameTiming Timing = InTiming;
+	Timing.GarbageCollectionMs = FPlatformTime::ToMilliseconds64(GarbageCollectionCycles);
+
+	if (Frames.Num() < Capacity)
+	{
+		Frames.Add(Timing);
+	}
+	else
+	{
+		Frames[Head] = Timing;
+		Head = (Head + 1) % Capacity;
+	}
+
+	if (HitchThresholdMs <= 0.0 || Timing.GameThreadMs <= HitchThresholdMs)
+	{
+		return;
+	}
+
+	FFrameHitch& Hitch = Hitches.AddDefaulted_GetRef();
+	Hitch.Timing = Timing;
+
+	if (!Sentinels.IsEmpty())
+	{
+		Hitch.TickGroupTimesMs.SetNumZeroed(TG_MAX);
+		// tick group lasts until the next tick group starts
+		double SlowestTimeMs = 0.0;
+		for (int32 Group = 0; Group < TG_MAX; ++Group)
+		{
+			if (TickGroupStartCycles[Group] == 0)
+			{
+				continue;
+			}
+
+			uint64 EndCycles = WorldTickEndCycles;
+			for (int32 NextGroup = Group + 1; NextGroup < TG_MAX; ++NextGroup)
+			{
+				if (TickGroupStartCycles[NextGroup] != 0)
+				{
+					EndCycles = TickGroupStartCycles[NextGroup];
+					break;
+				}
+			}
+
+			const double TimeMs = FPlatformTime::ToMilliseconds64(EndCycles - TickGroupStartCycles[Group]);
+			Hitch.TickGroupTimesMs[Group] = TimeMs;
+			if (TimeMs > SlowestTimeMs)
+			{
+				SlowestTimeMs = TimeMs;
+				Hitch.SlowestTickGroup = static_cast<ETickingGroup>(Group);
+			}
+		}
+	}
+
+	if (TickProfiler != nullptr)
+	{
+		Hitch.TickFunctions = TickProfiler->GetTopInstancesInLastFrame(NumHitchTickFunctions);
+	}
+}
+
+void UE::Automation::FFrameTimingRecorder::SetHitchThreshold(double InThresholdMs)
+{
+	HitchThresholdMs = InThresholdMs;
+	if (HitchThresholdMs <= 0.0)
+	{
+		UnregisterSentinels();
+	}
+}
+
+void UE::Automation::FFrameTimingRecorder::Reset()
+{
+	Frames.Reset();
+	Hitches.Reset();
+	Head = 0;
+}
+
+const UE::Automation::FFrameTiming& UE::Automation::FFrameTimingRecorder::GetFrame(int32 Index) const
+{
+	check(Frames.IsValidIndex(Index));
+	return Frames[(Head + Index) % Frames.Num()];
+}
+
+const UE::Automation::FFrameTiming* UE::Automation::FFrameTimingRecorder::GetLastFrame() const
+{
+	return Frames.IsEmpty() ? nullptr : &GetFrame(Frames.Num() - 1);
+}
+
+double UE::Automation::FFrameTimingRecorder::GetPercentile(EFrameTimingStat Stat, double Percentile) const
+{
+	if (Frames.IsEmpty())
+	{
+		return 0.0;
+	}
+
+	TArray<double> Values;
+	Values.Reserve(Frames.Num());
+	for (const FFrameTiming& Timing: Frames)
+	{
+		Values.Add(GetStat(Timing, Stat));
+	}
+	Algo::Sort(Values);
+
+	const int32 Rank = FMath::CeilToInt32(FMath::Clamp(Percentile, 0.0, 1.0) * Values.Num());
+	return Values[FMath::Clamp(Rank - 1, 0, Values.Num() - 1)];
+}
+
+double UE::Automation::FFrameTimingRecorder::GetMax(EFrameTimingStat Stat) const
+{
+	double Max = 0.0;
+	for (const FFrameTiming& Timing: Frames)
+	{
+		Max = FMath::Max(Max, GetStat(Timing, Stat));
+	}
+
+	return Max;
+}
+
+double UE::Automation::FFrameTimingRecorder::GetStat(const FFrameTiming& Timing, EFrameTimingStat Stat)
+{
+	switch (Stat)
+	{
+	case EFrameTimingStat::GameThread:			return Timing.GameThreadMs;
+	case EFrameTimingStat::WorldTick:			return Timing.WorldTickMs;
+	case EFrameTimingStat::Tickables:			return Timing.TickablesMs;
+	case EFrameTimingStat::GarbageCollection:	return Timing.GarbageCollectionMs;
+	default:
+		checkNoEntry();
+		return 0.0;
+	}
+}
+
+void UE::Automation::FFrameTimingRecorder::RegisterSentinels(UWorld* InWorld)
+{
+	check(InWorld && InWorld->PersistentLevel);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FFrameTimingRecorder_RegisterSentinels);
+
+	static constexpr ETickingGroup SentinelGroups[] = {TG_PrePhysics, TG_StartPhysics, TG_DuringPhysics, TG_EndPhysics, TG_PostPhysics, TG_PostUpdateWork, TG_LastDemotable};
+	for (const ETickingGroup Group: SentinelGroups)
+	{
+		TUniquePtr<FTickGroupSentinel>& Sentinel = Sentinels.Add_GetRef(MakeUnique<FTickGroupSentinel>(*this, Group));
+		Sentinel->RegisterTickFunction(InWorld->PersistentLevel);
+	}
+	SentinelWorld = InWorld;
+}
+
+void UE::Automation::FFrameTimingRecorder::UnregisterSentinels()
+{
+	for (TUniquePtr<FTickGroupSentinel>& Sentinel: Sentinels)
+	{
+		Sentinel->UnRegisterTickFunction();
+	}
+	Sentinels.Reset();
+	SentinelWorld = nullptr;
+}
+
+void UE::Automation::FFrameTimingRecorder::HandlePreGarbageCollect()
+{
+	GarbageCollectionStartCycles = FPlatformTime::Cycles64();
+}
+
+void UE::Automation::FFrameTimingRecorder::HandlePostGarbageCollect()
+{
+	if (GarbageCollectionStartCycles != 0)
+	{
+		const uint64 Cycles = FPlatformTime::Cycles64() - GarbageCollectionStartCycles;
+		GarbageCollectionCycles += Cycles;
+		TotalGarbageCollectionCycles += Cycles;
+		GarbageCollectionStartCycles = 0;
+	}
+}
@@ -0,0 +1,95 @@
+#include "AutomationLoadManifest.h"
+
+#include "CommonAutomationModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/PackagePath.h"
+#include "Misc/Paths.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+TArray<FName> UE::Automation::FLoadManifest::Load(const FString& TestName)
+{
+	TArray<FString> Lines;
+	if (!FFileHelper::LoadFileToStringArray(Lines, *GetFilename(TestName)))
+	{
+		return {};
+	}
+
+	TArray<FName> Packages;
+	Packages.Reserve(Lines.Num());
+	for (const FString& Line: Lines)
+	{
+		if (!Line.IsEmpty())
+		{
+			Packages.Add(FName{Line});
+		}
+	}
+
+	return Packages;
+}
+
+bool UE::Automation::FLoadManifest::Save(const FString& TestName, TConstArrayView<FName> Packages)
+{
+	TArray<FString> Lines;
+	Lines.Reserve(Packages.Num());
+	for (const FName Package: Packages)
+	{
+		if (CanPreload(Package))
+		{
+			Lines.Add(Package.ToString());
+		}
+	}
+
+	return FFileHelper::SaveStringArrayToFile(Lines, *GetFilename(TestName));
+}
+
+bool UE::Automation::FLoadManifest::CanPreload(FName Package)
+{
+	// world packages are instanced under /Temp, script and memory packages are never loaded from disk
+	const FNameBuilder PackageName{Package};
+	if (FPackageName::IsScriptPackage(PackageName) || FPackageName::IsMemoryPackage(PackageName) || FPackageName::IsTempPackage(PackageName))
+	{
+		return false;
+	}
+
+	// external actors and objects are instanced together with their world package
+	const FString PackageString{PackageName.ToView()};
+	if (PackageString.Contains(FPackagePath::GetExternalActorsFolderName()) || PackageString.Contains(FPackagePath::GetExternalObjectsFolderName()))
+	{
+		return false;
+	}
+
+	return IAssetRegistry::GetChecked().GetAssetPackageDataCopy(Package).IsSet();
+}
+
+int32 UE::Automation::FLoadManifest::Preload(TConstArrayView<FName> Packages)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FLoadManifest_Preload);
+	
+	const double StartTime = FPlatformTime::Seconds();
+	
+	TArray<int32> Requests;
+	Requests.Reserve(Packages.Num());
+	for (const FName Package: Packages)
+	{
+		if (FindObjectFast<UPackage>(nullptr, Package) == nullptr)
+		{
+			Requests.Add(LoadPackageAsync(Package.ToString()));
+		}
+	}
+
+	if (!Requests.IsEmpty())
+	{
+		FlushAsyncLoading(Requests);
+		UE_LOG(LogCommonAutomation, Verbose, TEXT("%s: preloaded %d packages in %.2fms"), *FString(__FUNCTION__), Requests.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	return Requests.Num();
+}
+
+FString UE::Automation::FLoadManifest::GetFilename(const FString& TestName)
+{
+	return FPaths::ProjectSavedDir() / TEXT("Automation") / TEXT("LoadManifests") / FPaths::MakeValidFileName(TestName, TEXT('_')) + TEXT(".txt");
+}
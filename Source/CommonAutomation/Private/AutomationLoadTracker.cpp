@@ -0,0 +1,228 @@
+#include "AutomationLoadTracker.h"
+
+#include "Misc/PackagePath.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+const TCHAR* UE::Automation::LexToString(ELoadPhase Phase)
+{
+	switch (Phase)
+	{
+	case ELoadPhase::MapLoad:	return TEXT("MapLoad");
+	case ELoadPhase::GameMode:	return TEXT("GameMode");
+	case ELoadPhase::BeginPlay:	return TEXT("BeginPlay");
+	case ELoadPhase::Runtime:	return TEXT("Runtime");
+	default:
+		checkNoEntry();
+		return TEXT("");
+	}
+}
+
+UE::Automation::FLoadPhaseStats& UE::Automation::FLoadPhaseStats::operator+=(const FLoadPhaseStats& Other)
+{
+	NumPackages += Other.NumPackages;
+	NumSyncPackages += Other.NumSyncPackages;
+	NumAsyncPackages += Other.NumAsyncPackages;
+	NumBytes += Other.NumBytes;
+	WallTimeMs += Other.WallTimeMs;
+
+	return *this;
+}
+
+UE::Automation::FPackageLoadTracker::FPackageLoadTracker(bool bInTrackClasses)
+	: bTrackClasses(bInTrackClasses)
+{
+	PhaseStartTime = FPlatformTime::Seconds();
+	EndLoadPackageHandle = FCoreUObjectDelegates::OnEndLoadPackage.AddRaw(this, &FPackageLoadTracker::HandleEndLoadPackage);
+	if (bTrackClasses)
+	{
+		GUObjectArray.AddUObjectCreateListener(this);
+	}
+	bListening = true;
+}
+
+UE::Automation::FPackageLoadTracker::~FPackageLoadTracker()
+{
+	Stop();
+}
+
+void UE::Automation::FPackageLoadTracker::Stop()
+{
+	if (!bListening)
+	{
+		return;
+	}
+	
+	FCoreUObjectDelegates::OnEndLoadPackage.Remove(EndLoadPackageHandle);
+	if (bTrackClasses)
+	{
+		GUObjectArray.RemoveUObjectCreateListener(this);
+	}
+	
+	PhaseStats[static_cast<int32>(CurrentPhase)].WallTimeMs += (FPlatformTime::Seconds() - PhaseStartTime) * 1000.0;
+	bListening = false;
+}
+
+UE::Automation::ELoadPhase UE::Automation::FPackageLoadTracker::SetPhase(ELoadPhase Phase)
+{
+	check(Phase != ELoadPhase::Num);
+	
+	const ELoadPhase PrevPhase = CurrentPhase;
+	if (bListening && Phase != CurrentPhase)
+	{
+		const double Now = FPlatformTime::Seconds();
+		PhaseStats[static_cast<int32>(CurrentPhase)].WallTimeMs += (Now - PhaseStartTime) * 1000.0;
+		PhaseStartTime = Now;
+		CurrentPhase = Phase;
+	}
+
+	return PrevPhase;
+}
+
+UE::Automation::FLoadPhaseStats UE::Automation::FPackageLoadTracker::GetPhaseStats(TOptional<ELoadPhase> Phase) const
+{
+	FLoadPhaseStats Stats;
+	for (int32 Index = 0; Index < static_cast<int32>(ELoadPhase::Num); ++Index)
+	{
+		const ELoadPhase StatsPhase = static_cast<ELoadPhase>(Index);
+		if (Phase.IsSet() ? *Phase == StatsPhase : IsCreationPhase(StatsPhase))
+		{
+			Stats += PhaseStats[Index];
+			if (bListening && StatsPhase == CurrentPhase)
+			{
+				Stats.WallTimeMs += (FPlatformTime::Seconds() - PhaseStartTime) * 1000.0;
+			}
+		}
+	}
+
+	return Stats;
+}
+
+TArray<UE::Automation::FPackageLoadCost> UE::Automation::FPackageLoadTracker::GetHeaviestPackages(int32 Num, TOptional<ELoadPhase> Phase) const
+{
+	TArray<FPackageLoadCost> Result;
+	for (const FPackageLoadCost& Cost: PackageCosts)
+	{
+		if (Phase.IsSet() ? *Phase == Cost.Phase : IsCreationPhase(Cost.Phase))
+		{
+			Result.Add(Cost);
+		}
+	}
+
+	Result.Sort([](const FPackageLoadCost& Lhs, const FPackageLoadCost& Rhs) { return Lhs.Bytes > Rhs.Bytes; });
+	if (Result.Num() > Num)
+	{
+		Result.SetNum(Num);
+	}
+
+	return Result;
+}
+
+TArray<FString> UE::Automation::FPackageLoadTracker::CheckBudget(const FLoadBudget& Budget) const
+{
+	const FLoadPhaseStats Stats = GetPhaseStats(Budget.Phase);
+	const TCHAR* PhaseName = Budget.Phase.IsSet() ? LexToString(*Budget.Phase) : TEXT("WorldCreation");
+	
+	TArray<FString> Violations;
+	if (Budget.MaxPackages > 0 && Stats.NumPackages > Budget.MaxPackages)
+	{
+		Violations.Add(FString::Printf(TEXT("%s loaded %d packages, budget is %d"), PhaseName, Stats.NumPackages, Budget.MaxPackages));
+	}
+	if (Budget.MaxSyncPackages > 0 && Stats.NumSyncPackages > Budget.MaxSyncPackages)
+	{
+		Violations.Add(FString::Printf(TEXT("%s loaded %d packages synchronously, budget is %d"), PhaseName, Stats.NumSyncPackages, Budget.MaxSyncPackages));
+	}
+	if (Budget.MaxBytes > 0 && Stats.NumBytes > Budget.MaxBytes)
+	{
+		Violations.Add(FString::Printf(TEXT("%s loaded %lld bytes, budget is %lld"), PhaseName, Stats.NumBytes, Budget.MaxBytes));
+	}
+	if (Budget.MaxWallTimeMs > 0.0 && Stats.WallTimeMs > Budget.MaxWallTimeMs)
+	{
+		Violations.Add(FString::Printf(TEXT("%s took %.2fms, budget is %.2fms"), PhaseName, Stats.WallTimeMs, Budget.MaxWallTimeMs));
+	}
+
+	return Violations;
+}
+
+TArray<FTopLevelAssetPath> UE::Automation::FPackageLoadTracker::GetInstantiatedClasses() const
+{
+	FScopeLock Lock{&ClassLock};
+	return Classes.Array();
+}
+
+TArray<FName> UE::Automation::FPackageLoadTracker::GetTouchedModules() const
+{
+	static const FString ScriptPrefix{TEXT("/Script/")};
+	
+	TSet<FName> Modules;
+	FScopeLock Lock{&ClassLock};
+	for (const FTopLevelAssetPath& Class: Classes)
+	{
+		// native class package is always /Script/<Module>
+		const FString PackageName = Class.GetPackageName().ToString();
+		if (PackageName.StartsWith(ScriptPrefix))
+		{
+			Modules.Add(FName{PackageName.RightChop(ScriptPrefix.Len())});
+		}
+	}
+
+	return Modules.Array();
+}
+
+void UE::Automation::FPackageLoadTracker::NotifyUObjectCreated(const UObjectBase* Object, int32 Index)
+{
+	const UClass* Class = Object->GetClass();
+	if (Class == nullptr)
+	{
+		return;
+	}
+	
+	FScopeLock Lock{&ClassLock};
+	if (Class != LastClass)
+	{
+		LastClass = Class;
+		Classes.Add(FTopLevelAssetPath{Class->GetOuter()->GetFName(), Class->GetFName()});
+	}
+}
+
+void UE::Automation::FPackageLoadTracker::OnUObjectArrayShutdown()
+{
+	GUObjectArray.RemoveUObjectCreateListener(this);
+	bTrackClasses = false;
+}
+
+void UE::Automation::FPackageLoadTracker::HandleEndLoadPackage(const FEndLoadPackageContext& Context)
+{
+	for (const UPackage* Package: Context.LoadedPackages)
+	{
+		if (Package == nullptr)
+		{
+			continue;
+		}
+		
+		// instanced packages, e.g. automation world package under /Temp, are recorded by the package they were loaded from
+		const FPackagePath& LoadedPath = Package->GetLoadedPath();
+		const FName PackageName = LoadedPath.IsEmpty() ? Package->GetFName() : LoadedPath.GetPackageFName();
+		bool bAlreadyLoaded = false;
+		LoadedPackageSet.Add(PackageName, &bAlreadyLoaded);
+		if (bAlreadyLoaded)
+		{
+			continue;
+		}
+		
+		LoadedPackages.Add(PackageName);
+		const FPackageLoadCost& Cost = PackageCosts.Add_GetRef({PackageName, FMath::Max<int64>(Package->GetFileSize(), 0), CurrentPhase, Context.bSynchronous});
+
+		FLoadPhaseStats& Stats = PhaseStats[static_cast<int32>(CurrentPhase)];
+		++Stats.NumPackages;
+		Stats.NumBytes += Cost.Bytes;
+		if (Cost.bSynchronous)
+		{
+			++Stats.NumSyncPackages;
+		}
+		else
+		{
+			++Stats.NumAsyncPackages;
+		}
+	}
+}
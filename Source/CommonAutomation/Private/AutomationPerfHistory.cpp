@@ -0,0 +1,307 @@
+#include "AutomationPerfHistory.h"
+
+#include "CommonAutomationModule.h"
+#include "Algo/Reverse.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+
+namespace UE::Automation
+{
+	static constexpr uint32 PerfHistoryMagic = 0x48504143; // CAPH
+	static constexpr int32 PerfHistoryEntryVersion = 2;
+
+	static FAutoConsoleCommand ReportPerfHistoryCommand(
+		TEXT("CommonAutomation.PerfHistoryReport"),
+		TEXT("Report tests which latest performance history entry regressed against previous entries. Optional argument: number of previous entries to compare against"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const int32 NumHistory = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 20;
+			
+			FPerfHistory History;
+			if (!History.Load())
+			{
+				return;
+			}
+
+			TSet<FString> TestNames;
+			for (const FPerfHistoryEntry& Entry: History.GetEntries())
+			{
+				TestNames.Add(Entry.TestName);
+			}
+
+			int32 NumRegressed = 0;
+			for (const FString& TestName: TestNames)
+			{
+				TArray<const FPerfHistoryEntry*> TestHistory = History.GetTestHistory(TestName, NumHistory + 1);
+				const FPerfHistoryEntry* Latest = TestHistory.Pop();
+				
+				const TArray<FPerfRegression> Regressions = FPerfHistory::FindRegressions(*Latest, TestHistory);
+				NumRegressed += Regressions.IsEmpty() ? 0 : 1;
+				for (const FPerfRegression& Regression: Regressions)
+				{
+					UE_LOG(LogCommonAutomation, Warning, TEXT("%s (CL %u): %s regressed to %.3f, history mean %.3f, stddev %.3f"),
+						*TestName, Latest->Changelist, FPerfHistory::GetMetricName(Regression.Metric), Regression.Value, Regression.HistoryMean, Regression.HistoryStdDev);
+				}
+			}
+			
+			UE_LOG(LogCommonAutomation, Display, TEXT("Performance history: %d tests, %d regressed"), TestNames.Num(), NumRegressed);
+		})
+	);
+}
+
+FArchive& UE::Automation::operator<<(FArchive& Ar, FPerfHistoryEntry& Entry)
+{
+	Ar << Entry.TestName;
+	Ar << Entry.Changelist;
+	Ar << Entry.BuildVersion;
+	Ar << Entry.Timestamp;
+	Ar << Entry.WorldCreationMs;
+	Ar << Entry.TickP50Ms;
+	Ar << Entry.TickP95Ms;
+	Ar << Entry.TickP99Ms;
+	Ar << Entry.PeakUsedMemoryDelta;
+	Ar << Entry.PackagesLoaded;
+	Ar << Entry.GarbageCollectionMs;
+
+	return Ar;
+}
+
+UE::Automation::FPerfHistory::FPerfHistory(const FString& InFilename)
+	: Filename(InFilename)
+{
+	
+}
+
+bool UE::Automation::FPerfHistory::Load()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FPerfHistory_Load);
+	
+	Entries.Reset();
+	if (!IFileManager::Get().FileExists(*Filename))
+	{
+		return true;
+	}
+
+	TUniquePtr<FArchive> Reader{IFileManager::Get().CreateFileReader(*Filename)};
+	if (!Reader.IsValid())
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	if (Reader->TotalSize() < static_cast<int64>(sizeof(Magic)))
+	{
+		UE_LOG(LogCommonAutomation, Warning, TEXT("%s: %s has a truncated header"), *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+	
+	*Reader << Magic;
+	if (Magic != PerfHistoryMagic)
+	{
+		UE_LOG(LogCommonAutomation, Warning, TEXT("%s: %s is not a performance history file"), *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+
+	while (!Reader->AtEnd() && !Reader->IsError())
+	{
+		int32 Version = 0;
+		int64 Size = 0;
+		if (Reader->TotalSize() - Reader->Tell() < static_cast<int64>(sizeof(Version) + sizeof(Size)))
+		{
+			// truncated record header, e.g. process was killed while writing
+			break;
+		}
+		*Reader << Version << Size;
+
+		const int64 RecordEnd = Reader->Tell() + Size;
+		if (Size <= 0 || RecordEnd > Reader->TotalSize())
+		{
+			// truncated record, e.g. process was killed while writing
+			break;
+		}
+		
+		if (Version == PerfHistoryEntryVersion)
+		{
+			*Reader << Entries.AddDefaulted_GetRef();
+		}
+		Reader->Seek(RecordEnd);
+	}
+
+	return !Reader->IsError();
+}
+
+bool UE::Automation::FPerfHistory::Append(const FPerfHistoryEntry& Entry)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FPerfHistory_Append);
+	
+	TArray<uint8> Record;
+	FMemoryWriter Writer{Record};
+	Writer << const_cast<FPerfHistoryEntry&>(Entry);
+
+	const bool bNewFile = !IFileManager::Get().FileExists(*Filename);
+	TUniquePtr<FArchive> FileWriter{IFileManager::Get().CreateFileWriter(*Filename, FILEWRITE_Append)};
+	if (!FileWriter.IsValid())
+	{
+		UE_LOG(LogCommonAutomation, Warning, TEXT("%s: failed to open %s"), *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+
+	if (bNewFile)
+	{
+		uint32 Magic = PerfHistoryMagic;
+		*FileWriter << Magic;
+	}
+
+	int32 Version = PerfHistoryEntryVersion;
+	int64 Size = Record.Num();
+	*FileWriter << Version << Size;
+	FileWriter->Serialize(Record.GetData(), Record.Num());
+	
+	Entries.Add(Entry);
+	return FileWriter->Close();
+}
+
+TArray<const UE::Automation::FPerfHistoryEntry*> UE::Automation::FPerfHistory::GetTestHistory(const FString& TestName, int32 MaxEntries) const
+{
+	TArray<const FPerfHistoryEntry*> History;
+	for (int32 Index = Entries.Num() - 1; Index >= 0 && History.Num() < MaxEntries; --Index)
+	{
+		if (Entries[Index].TestName == TestName)
+		{
+			History.Add(&Entries[Index]);
+		}
+	}
+	Algo::Reverse(History);
+	
+	return History;
+}
+
+TArray<UE::Automation::FPerfRegression> UE::Automation::FPerfHistory::FindRegressions(const FPerfHistoryEntry& Entry, TConstArrayView<const FPerfHistoryEntry*> History,
+	double ZThreshold, double MinRelativeIncrease, int32 MinHistory)
+{
+	TArray<FPerfRegression> Regressions;
+	if (History.Num() < FMath::Max(MinHistory, 2))
+	{
+		return Regressions;
+	}
+
+	for (uint8 MetricIndex = 0; MetricIndex < static_cast<uint8>(EPerfMetric::Num); ++MetricIndex)
+	{
+		const EPerfMetric Metric = static_cast<EPerfMetric>(MetricIndex);
+		
+		double Mean = 0.0;
+		for (const FPerfHistoryEntry* HistoryEntry: History)
+		{
+			Mean += GetMetric(*HistoryEntry, Metric);
+		}
+		Mean /= History.Num();
+
+		double Variance = 0.0;
+		for (const FPerfHistoryEntry* HistoryEntry: History)
+		{
+			Variance += FMath::Square(GetMetric(*HistoryEntry, Metric) - Mean);
+		}
+		const double StdDev = FMath::Sqrt(Variance / (History.Num() - 1));
+
+		const double Value = GetMetric(Entry, Metric);
+		if (Value <= Mean * (1.0 + MinRelativeIncrease) || Value - Mean < GetMinIncrease(Metric))
+		{
+			continue;
+		}
+
+		// stable history, any increase above relative and absolute thresholds is significant
+		const double ZScore = StdDev > UE_SMALL_NUMBER ? (Value - Mean) / StdDev : UE_BIG_NUMBER;
+		if (ZScore > ZThreshold)
+		{
+			Regressions.Add({Metric, Value, Mean, StdDev, ZScore});
+		}
+	}
+
+	return Regressions;
+}
+
+double UE::Automation::FPerfHistory::GetMetric(const FPerfHistoryEntry& Entry, EPerfMetric Metric)
+{
+	switch (Metric)
+	{
+	case EPerfMetric::WorldCreation:		return Entry.WorldCreationMs;
+	case EPerfMetric::TickP50:				return Entry.TickP50Ms;
+	case EPerfMetric::TickP95:				return Entry.TickP95Ms;
+	case EPerfMetric::TickP99:				return Entry.TickP99Ms;
+	case EPerfMetric::PeakMemory:			return static_cast<double>(Entry.PeakUsedMemoryDelta);
+	case EPerfMetric::PackagesLoaded:		return Entry.PackagesLoaded;
+	case EPerfMetric::GarbageCollection:	return Entry.GarbageCollectionMs;
+	default:
+		checkNoEntry();
+		return 0.0;
+	}
+}
+
+double UE::Automation::FPerfHistory::GetMinIncrease(EPerfMetric Metric)
+{
+	switch (Metric)
+	{
+	case EPerfMetric::WorldCreation:		return 1.0;
+	case EPerfMetric::TickP50:				return 0.1;
+	case EPerfMetric::TickP95:				return 0.25;
+	case EPerfMetric::TickP99:				return 0.5;
+	case EPerfMetric::PeakMemory:			return 16.0 * 1024 * 1024;
+	case EPerfMetric::PackagesLoaded:		return 1.0;
+	case EPerfMetric::GarbageCollection:	return 1.0;
+	default:
+		checkNoEntry();
+		return 0.0;
+	}
+}
+
+const TCHAR* UE::Automation::FPerfHistory::GetMetricName(EPerfMetric Metric)
+{
+	switch (Metric)
+	{
+	case EPerfMetric::WorldCreation:		return TEXT("WorldCreationMs");
+	case EPerfMetric::TickP50:				return TEXT("TickP50Ms");
+	case EPerfMetric::TickP95:				return TEXT("TickP95Ms");
+	case EPerfMetric::TickP99:				return TEXT("TickP99Ms");
+	case EPerfMetric::PeakMemory:			return TEXT("PeakUsedMemoryDelta");
+	case EPerfMetric::PackagesLoaded:		return TEXT("PackagesLoaded");
+	case EPerfMetric::GarbageCollection:	return TEXT("GarbageCollectionMs");
+	default:
+		checkNoEntry();
+		return TEXT("");
+	}
+}
+
+FString UE::Automation::FPerfHistory::GetDefaultFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Automation") / TEXT("PerfHistory.bin");
+}
+
+uint32 UE::Automation::FPerfHistory::GetBuildChangelist()
+{
+	uint32 Changelist = 0;
+	if (FParse::Value(FCommandLine::Get(), TEXT("-AutomationChangelist="), Changelist))
+	{
+		return Changelist;
+	}
+
+	// set by AutomationTool for every build step
+	const FString EnvChangelist = FPlatformMisc::GetEnvironmentVariable(TEXT("uebp_CL"));
+	if (!EnvChangelist.IsEmpty() && FCString::IsNumeric(*EnvChangelist))
+	{
+		return FCString::Atoi(*EnvChangelist);
+	}
+
+	// build version is stamped by the build farm, e.g. ++Project+Main-CL-12345. Engine changelist doesn't follow project content
+	const FString BuildVersion = FApp::GetBuildVersion();
+	const int32 Index = BuildVersion.Find(TEXT("-CL-"), ESearchCase::IgnoreCase, ESearchDir::FromEnd);
+	if (Index != INDEX_NONE)
+	{
+		return FCString::Atoi(*BuildVersion.RightChop(Index + 4));
+	}
+
+	return 0;
+}
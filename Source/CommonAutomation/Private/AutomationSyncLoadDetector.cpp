@@ -0,0 +1,76 @@
+#include "AutomationSyncLoadDetector.h"
+
+#include "AutomationTickProfiler.h"
+#include "HAL/PlatformStackWalk.h"
+#include "UObject/UObjectGlobals.h"
+
+UE::Automation::FSyncLoadDetector::FSyncLoadDetector(ESyncLoadPolicy InPolicy)
+	: Policy(InPolicy)
+{
+	SyncLoadHandle = FCoreUObjectDelegates::OnSyncLoadPackage.AddRaw(this, &FSyncLoadDetector::HandleSyncLoadPackage);
+}
+
+UE::Automation::FSyncLoadDetector::~FSyncLoadDetector()
+{
+	FCoreUObjectDelegates::OnSyncLoadPackage.Remove(SyncLoadHandle);
+}
+
+FString UE::Automation::FSyncLoadDetector::FormatSyncLoad(const FSyncLoad& SyncLoad)
+{
+	TStringBuilder<2048> Builder;
+	Builder.Appendf(TEXT("Synchronous load of %s during frame %llu"), *SyncLoad.PackageName, SyncLoad.Frame);
+	if (!SyncLoad.Requester.IsEmpty())
+	{
+		Builder.Appendf(TEXT(" requested by %s"), *SyncLoad.Requester);
+	}
+	if (SyncLoad.Count > 1)
+	{
+		Builder.Appendf(TEXT(", %d times"), SyncLoad.Count);
+	}
+
+	FPlatformStackWalk::InitStackWalking();
+	for (int32 Index = 0; Index < SyncLoad.Callstack.Num(); ++Index)
+	{
+		ANSICHAR Symbol[1024];
+		Symbol[0] = '\0';
+		FPlatformStackWalk::ProgramCounterToHumanReadableString(Index, SyncLoad.Callstack[Index], Symbol, UE_ARRAY_COUNT(Symbol));
+		Builder << TEXT("\n\t") << ANSI_TO_TCHAR(Symbol);
+	}
+
+	return Builder.ToString();
+}
+
+void UE::Automation::FSyncLoadDetector::HandleSyncLoadPackage(const FString& PackageName)
+{
+	if (!bActive || !IsInGameThread())
+	{
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FSyncLoadDetector_HandleSyncLoad);
+	
+	constexpr int32 MaxDepth = 32;
+	// skip detector and load package frames
+	constexpr int32 NumIgnoredFrames = 3;
+	uint64 Callstack[MaxDepth + NumIgnoredFrames];
+	const int32 Depth = FPlatformStackWalk::CaptureStackBackTrace(Callstack, UE_ARRAY_COUNT(Callstack));
+	const TArrayView<uint64> Frames{Callstack + FMath::Min(Depth, NumIgnoredFrames), FMath::Max(Depth - NumIgnoredFrames, 0)};
+
+	const UObject* RequesterObject = TickProfiler != nullptr ? TickProfiler->GetCurrentTarget() : nullptr;
+	const FString Requester = RequesterObject != nullptr ? RequesterObject->GetPathName() : FString{};
+	
+	uint32 Hash = HashCombineFast(GetTypeHash(PackageName), GetTypeHash(Requester));
+	for (const uint64 ProgramCounter: Frames)
+	{
+		Hash = HashCombineFast(Hash, GetTypeHash(ProgramCounter));
+	}
+
+	if (const int32* Index = SyncLoadIndices.Find(Hash))
+	{
+		++SyncLoads[*Index].Count;
+		return;
+	}
+
+	SyncLoadIndices.Add(Hash, SyncLoads.Num());
+	SyncLoads.Add({PackageName, Requester, Frame, 1, TArray<uint64>(Frames.GetData(), Frames.Num())});
+}
@@ -0,0 +1,430 @@
+#include "AutomationTestDependencies.h"
+
+#include "AutomationLoadTracker.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "CommonAutomationModule.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace UE::Automation
+{
+	template <typename T>
+	static TArray<TSharedPtr<FJsonValue>> ToJsonArray(const TSet<T>& Values)
+	{
+		TArray<TSharedPtr<FJsonValue>> Result;
+		Result.Reserve(Values.Num());
+		for (const T& Value: Values)
+		{
+			Result.Add(MakeShared<FJsonValueString>(LexToString(Value)));
+		}
+		
+		return Result;
+	}
+
+	template <typename T>
+	static void FromJsonArray(const TSharedPtr<FJsonObject>& Json, const TCHAR* Field, TSet<T>& OutValues)
+	{
+		const TArray<TSharedPtr<FJsonValue>>* Values = nullptr;
+		if (Json->TryGetArrayField(Field, Values))
+		{
+			OutValues.Reserve(Values->Num());
+			for (const TSharedPtr<FJsonValue>& Value: *Values)
+			{
+				OutValues.Add(T{Value->AsString()});
+			}
+		}
+	}
+
+	/** @return absolute path for a changed file, relative paths are resolved against project and root directories */
+	static FString ResolveChangedFile(const FString& File)
+	{
+		if (!FPaths::IsRelative(File))
+		{
+			return FPaths::ConvertRelativePathToFull(File);
+		}
+		
+		for (const FString& BaseDir: {FPaths::ProjectDir(), FPaths::RootDir()})
+		{
+			const FString FullPath = FPaths::ConvertRelativePathToFull(BaseDir, File);
+			if (FPaths::FileExists(FullPath))
+			{
+				return FullPath;
+			}
+		}
+
+		// deleted file, assume it is relative to project
+		return FPaths::ConvertRelativePathToFull(FPaths::ProjectDir(), File);
+	}
+
+	static bool IsSourceFile(const FString& Extension)
+	{
+		static const TCHAR* SourceExtensions[] = {TEXT("h"), TEXT("hpp"), TEXT("inl"), TEXT("c"), TEXT("cpp"), TEXT("cs")};
+		for (const TCHAR* SourceExtension: SourceExtensions)
+		{
+			if (Extension == SourceExtension)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+UE::Automation::FTestDependencyMap::FTestDependencyMap(const FString& InFilename)
+	: Filename(InFilename)
+{
+	
+}
+
+bool UE::Automation::FTestDependencyMap::Load()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTestDependencyMap_Load);
+	
+	Tests.Reset();
+	
+	FString Content;
+	if (!FFileHelper::LoadFileToString(Content, *Filename))
+	{
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Json;
+	if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Content), Json) || !Json.IsValid())
+	{
+		UE_LOG(LogCommonAutomation, Warning, TEXT("%s: Failed to parse %s"), *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+
+	if (Json->GetIntegerField(TEXT("version")) != Version)
+	{
+		UE_LOG(LogCommonAutomation, Display, TEXT("%s: %s has a different version, ignored"), *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+
+	const TSharedPtr<FJsonObject>* TestsJson = nullptr;
+	if (!Json->TryGetObjectField(TEXT("tests"), TestsJson))
+	{
+		return false;
+	}
+
+	for (const TPair<FString, TSharedPtr<FJsonValue>>& TestJson: (*TestsJson)->Values)
+	{
+		const TSharedPtr<FJsonObject> Object = TestJson.Value->AsObject();
+		if (!Object.IsValid())
+		{
+			continue;
+		}
+		
+		FTestDependencies& Dependencies = Tests.Add(TestJson.Key);
+		FDateTime::ParseIso8601(*Object->GetStringField(TEXT("timestamp")), Dependencies.Timestamp);
+		Dependencies.SourceFile = Object->GetStringField(TEXT("source"));
+		FromJsonArray(Object, TEXT("packages"), Dependencies.Packages);
+		FromJsonArray(Object, TEXT("classes"), Dependencies.Classes);
+		FromJsonArray(Object, TEXT("modules"), Dependencies.Modules);
+	}
+
+	return true;
+}
+
+bool UE::Automation::FTestDependencyMap::Save() const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTestDependencyMap_Save);
+	
+	const TSharedRef<FJsonObject> TestsJson = MakeShared<FJsonObject>();
+	for (const TPair<FString, FTestDependencies>& Test: Tests)
+	{
+		const TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("timestamp"), Test.Value.Timestamp.ToIso8601());
+		Object->SetStringField(TEXT("source"), Test.Value.SourceFile);
+		Object->SetArrayField(TEXT("packages"), ToJsonArray(Test.Value.Packages));
+		Object->SetArrayField(TEXT("classes"), ToJsonArray(Test.Value.Classes));
+		Object->SetArrayField(TEXT("modules"), ToJsonArray(Test.Value.Modules));
+		TestsJson->SetObjectField(Test.Key, Object);
+	}
+
+	const TSharedRef<FJsonObject> Json = MakeShared<FJsonObject>();
+	Json->SetNumberField(TEXT("version"), Version);
+	Json->SetObjectField(TEXT("tests"), TestsJson);
+	
+	FString Output;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Output);
+	FJsonSerializer::Serialize(Json, Writer);
+
+	if (!FFileHelper::SaveStringToFile(Output, *Filename))
+	{
+		UE_LOG(LogCommonAutomation, Warning, TEXT("%s: Failed to write %s"), *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+void UE::Automation::FTestDependencyMap::Record(const FString& TestName, const FString& SourceFile, const FPackageLoadTracker& Tracker, FName WorldPackage)
+{
+	FTestDependencies Dependencies;
+	Dependencies.SourceFile = SourceFile.IsEmpty() ? FString{} : FPaths::ConvertRelativePathToFull(SourceFile);
+	if (!WorldPackage.IsNone())
+	{
+		Dependencies.Packages = GetDependencyClosure(WorldPackage);
+	}
+	Dependencies.Packages.Append(Tracker.GetLoadedPackages());
+	Dependencies.Modules.Append(Tracker.GetTouchedModules());
+	for (const FTopLevelAssetPath& Class: Tracker.GetInstantiatedClasses())
+	{
+		Dependencies.Classes.Add(Class.ToString());
+	}
+
+	Record(TestName, MoveTemp(Dependencies));
+}
+
+void UE::Automation::FTestDependencyMap::Record(const FString& TestName, FTestDependencies&& Dependencies)
+{
+	Dependencies.Timestamp = FDateTime::UtcNow();
+	
+	bool bAlreadyRecorded = false;
+	RecordedTests.Add(TestName, &bAlreadyRecorded);
+
+	FTestDependencies* Existing = Tests.Find(TestName);
+	if (!bAlreadyRecorded || Existing == nullptr)
+	{
+		// first world of the test in this session replaces outdated dependencies
+		Tests.Add(TestName, MoveTemp(Dependencies));
+		return;
+	}
+
+	Existing->Packages.Append(Dependencies.Packages);
+	Existing->Classes.Append(Dependencies.Classes);
+	Existing->Modules.Append(Dependencies.Modules);
+	Existing->Timestamp = Dependencies.Timestamp;
+}
+
+const UE::Automation::FTestDependencies* UE::Automation::FTestDependencyMap::Find(const FString& TestName) const
+{
+	return Tests.Find(TestName);
+}
+
+FDateTime UE::Automation::FTestDependencyMap::GetOldestTimestamp() const
+{
+	FDateTime Oldest = FDateTime::MaxValue();
+	for (const TPair<FString, FTestDependencies>& Test: Tests)
+	{
+		Oldest = FMath::Min(Oldest, Test.Value.Timestamp);
+	}
+
+	return Oldest;
+}
+
+UE::Automation::FTestSelection UE::Automation::FTestDependencyMap::SelectAffectedTests(TConstArrayView<FString> ChangedFiles, double MaxAgeDays) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTestDependencyMap_SelectAffectedTests);
+	
+	FTestSelection Selection;
+	auto FullRun = [&Selection](FString&& Reason)
+	{
+		Selection.bFullRun = true;
+		Selection.Reason = MoveTemp(Reason);
+		Selection.Tests.Reset();
+		return Selection;
+	};
+	
+	if (Tests.IsEmpty())
+	{
+		return FullRun(TEXT("test dependency map is empty"));
+	}
+
+	const FTimespan Age = FDateTime::UtcNow() - GetOldestTimestamp();
+	if (MaxAgeDays > 0.0 && Age.GetTotalDays() > MaxAgeDays)
+	{
+		return FullRun(FString::Printf(TEXT("test dependency map is %.1f days old"), Age.GetTotalDays()));
+	}
+
+	TSet<FString> Affected;
+	for (const FString& Changed: ChangedFiles)
+	{
+		const FString Extension = FPaths::GetExtension(Changed);
+		if (Extension.IsEmpty() && FPackageName::IsValidLongPackageName(Changed))
+		{
+			const FName PackageName{Changed};
+			for (const TPair<FString, FTestDependencies>& Test: Tests)
+			{
+				if (Test.Value.Packages.Contains(PackageName))
+				{
+					Affected.Add(Test.Key);
+				}
+			}
+			continue;
+		}
+
+		const FString FullPath = ResolveChangedFile(Changed);
+		if (Extension == TEXT("uasset") || Extension == TEXT("umap"))
+		{
+			FString PackageName;
+			if (!FPackageName::TryConvertFilenameToLongPackageName(FullPath, PackageName))
+			{
+				return FullRun(FString::Printf(TEXT("%s is not a package of a mounted content root"), *Changed));
+			}
+			
+			const FName PackageFName{PackageName};
+			for (const TPair<FString, FTestDependencies>& Test: Tests)
+			{
+				if (Test.Value.Packages.Contains(PackageFName))
+				{
+					Affected.Add(Test.Key);
+				}
+			}
+			continue;
+		}
+
+		if (!IsSourceFile(Extension))
+		{
+			return FullRun(FString::Printf(TEXT("%s is neither content nor source file"), *Changed));
+		}
+		
+		// test sources are matched directly, tests rarely instantiate classes of their own module
+		bool bMatched = false;
+		for (const TPair<FString, FTestDependencies>& Test: Tests)
+		{
+			if (Test.Value.SourceFile == FullPath)
+			{
+				Affected.Add(Test.Key);
+				bMatched = true;
+			}
+		}
+
+		const FName Module = GetSourceFileModule(FullPath);
+		if (Module.IsNone())
+		{
+			return FullRun(FString::Printf(TEXT("%s doesn't belong to a module"), *Changed));
+		}
+		
+		for (const TPair<FString, FTestDependencies>& Test: Tests)
+		{
+			if (Test.Value.Modules.Contains(Module))
+			{
+				Affected.Add(Test.Key);
+				bMatched = true;
+			}
+		}
+
+		if (!bMatched)
+		{
+			// module code can be used without instantiating any of its classes
+			return FullRun(FString::Printf(TEXT("module %s of %s is not recorded for any test"), *Module.ToString(), *Changed));
+		}
+	}
+
+	Selection.Tests = Affected.Array();
+	Selection.Tests.Sort();
+	
+	return Selection;
+}
+
+TSet<FName> UE::Automation::FTestDependencyMap::GetDependencyClosure(FName Package)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTestDependencyMap_GetDependencyClosure);
+	
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	
+	TSet<FName> Closure{Package};
+	TArray<FName> Pending{Package};
+	TArray<FName> Dependencies;
+	while (!Pending.IsEmpty())
+	{
+		Dependencies.Reset();
+		// soft references are loaded on demand, they are recorded by the load tracker if test loads them
+		AssetRegistry.GetDependencies(Pending.Pop(), Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+		for (const FName Dependency: Dependencies)
+		{
+			bool bAlreadyAdded = false;
+			if (!FPackageName::IsScriptPackage(FNameBuilder{Dependency}))
+			{
+				Closure.Add(Dependency, &bAlreadyAdded);
+				if (!bAlreadyAdded)
+				{
+					Pending.Add(Dependency);
+				}
+			}
+		}
+	}
+
+	return Closure;
+}
+
+FName UE::Automation::FTestDependencyMap::GetSourceFileModule(const FString& SourceFile)
+{
+	if (SourceFile.EndsWith(TEXT(".Build.cs")))
+	{
+		return FName{FPaths::GetCleanFilename(SourceFile).LeftChop(9)};
+	}
+	
+	FString Directory = FPaths::GetPath(SourceFile);
+	while (!Directory.IsEmpty())
+	{
+		TArray<FString> BuildFiles;
+		IFileManager::Get().FindFiles(BuildFiles, *(Directory / TEXT("*.Build.cs")), true, false);
+		if (!BuildFiles.IsEmpty())
+		{
+			return FName{BuildFiles[0].LeftChop(9)};
+		}
+
+		const FString Parent = FPaths::GetPath(Directory);
+		if (Parent == Directory)
+		{
+			break;
+		}
+		Directory = Parent;
+	}
+
+	return NAME_None;
+}
+
+UE::Automation::FTestDependencyMap& UE::Automation::FTestDependencyMap::GetSessionMap()
+{
+	static TOptional<FTestDependencyMap> SessionMap;
+	if (!SessionMap.IsSet())
+	{
+		SessionMap.Emplace();
+		SessionMap->Load();
+		FAutomationTestFramework::Get().OnAfterAllTestsEvent.AddLambda([]
+		{
+			SessionMap->Save();
+		});
+	}
+
+	return SessionMap.GetValue();
+}
+
+FString UE::Automation::FTestDependencyMap::GetTestPath(const FAutomationTestBase& Test)
+{
+	// same source as test selection, which enumerates tests with FAutomationTestFramework::GetValidTestNames
+	TArray<FAutomationTestInfo> TestInfos;
+	Test.GenerateTestNames(TestInfos);
+	if (TestInfos.Num() == 1)
+	{
+		return TestInfos[0].GetFullTestPath();
+	}
+
+	const FString Parameter = Test.GetTestContext();
+	for (const FAutomationTestInfo& TestInfo: TestInfos)
+	{
+		if (TestInfo.GetTestParameter() == Parameter)
+		{
+			return TestInfo.GetFullTestPath();
+		}
+	}
+
+	UE_LOG(LogCommonAutomation, Warning, TEXT("%s: Running parameter of %s is unknown"), *FString(__FUNCTION__), *Test.GetTestFullName());
+	return Test.GetBeautifiedTestName();
+}
+
+FString UE::Automation::FTestDependencyMap::GetDefaultFilename()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Automation") / TEXT("TestDependencies.json");
+}
@@ -0,0 +1,326 @@
+#include "AutomationTickProfiler.h"
+
+#include "EngineUtils.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+struct UE::Automation::FTickProfiler::FProfiledTickFunction: public FTickFunction
+{
+	FProfiledTickFunction(FTickProfiler& InProfiler, FTickFunction& InOriginal, UObject* InTarget, FInstanceStats& InStats)
+		: Profiler(&InProfiler)
+		, Original(&InOriginal)
+		, Target(InTarget)
+		, Stats(&InStats)
+	{
+		TickGroup = Original->TickGroup;
+		EndTickGroup = Original->EndTickGroup;
+		TickInterval = Original->TickInterval;
+		bTickEvenWhenPaused = Original->bTickEvenWhenPaused;
+		bAllowTickOnDedicatedServer = Original->bAllowTickOnDedicatedServer;
+		bHighPriority = Original->bHighPriority;
+		// time is measured on game thread
+		bRunOnAnyThread = false;
+		bCanEverTick = true;
+		bStartWithTickEnabled = true;
+	}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override
+	{
+		// original tick function lives inside target, don't touch it if target is gone
+		if (!Target.IsValid() || !Original->IsTickFunctionEnabled())
+		{
+			return;
+		}
+
+		if (Original->IsTickFunctionRegistered())
+		{
+			// original tick function was registered again (e.g. component was re-registered), engine ticks it on its own
+			return;
+		}
+
+		TGuardValue<UObject*> CurrentTarget{Profiler->CurrentTarget, Target.Get()};
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		Original->ExecuteTick(DeltaTime, TickType, CurrentThread, MyCompletionGraphEvent);
+		
+		const uint64 Cycles = FPlatformTime::Cycles64() - StartCycles;
+		
+		Stats->TotalCycles += Cycles;
+		++Stats->NumTicks;
+		
+		if (Stats->Frame != Profiler->NumFrames)
+		{
+			Stats->Frame = Profiler->NumFrames;
+			Stats->FrameCycles = 0;
+		}
+		Stats->FrameCycles += Cycles;
+	}
+
+	virtual FString DiagnosticMessage() override
+	{
+		return TEXT("[Profiled]") + (Target.IsValid() ? Original->DiagnosticMessage() : FString{});
+	}
+
+	FTickProfiler* Profiler = nullptr;
+	FTickFunction* Original = nullptr;
+	TWeakObjectPtr<UObject> Target;
+	/** stats owned by profiler */
+	FInstanceStats* Stats = nullptr;
+	/** level original tick function was registered in */
+	TWeakObjectPtr<ULevel> Level;
+};
+
+UE::Automation::FTickProfiler::FTickProfiler(UWorld* InWorld)
+	: World(InWorld)
+{
+	check(World);
+}
+
+UE::Automation::FTickProfiler::~FTickProfiler()
+{
+	RestoreTickFunctions();
+}
+
+void UE::Automation::FTickProfiler::WrapTickFunctions()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTickProfiler_WrapTickFunctions);
+	
+	++NumFrames;
+	const int32 NumProxies = Proxies.Num();
+	
+	for (TActorIterator<AActor> It{World}; It; ++It)
+	{
+		AActor* Actor = *It;
+		if (Actor->PrimaryActorTick.IsTickFunctionRegistered())
+		{
+			WrapTickFunction(Actor->PrimaryActorTick, Actor, Actor->GetLevel());
+		}
+
+		for (UActorComponent* Component: Actor->GetComponents())
+		{
+			if (Component != nullptr && Component->PrimaryComponentTick.IsTickFunctionRegistered())
+			{
+				WrapTickFunction(Component->PrimaryComponentTick, Component, Component->GetComponentLevel());
+			}
+		}
+	}
+
+	if (Proxies.Num() != NumProxies)
+	{
+		UpdatePrerequisites();
+	}
+}
+
+void UE::Automation::FTickProfiler::WrapTickFunction(FTickFunction& TickFunction, UObject* Target, ULevel* Level)
+{
+	if (Level == nullptr)
+	{
+		return;
+	}
+	
+	if (TUniquePtr<FProfiledTickFunction>* ExistingProxy = Proxies.Find(&TickFunction))
+	{
+		if ((*ExistingProxy)->Target.Get() == Target)
+		{
+			// original tick function was registered again, proxy still exists
+			TickFunction.UnRegisterTickFunction();
+			return;
+		}
+		
+		// tick function memory is reused by another object
+		Proxies.Remove(&TickFunction);
+	}
+	
+	TUniquePtr<FInstanceStats>& StatsPtr = Instances.FindOrAdd(FObjectKey{Target});
+	if (!StatsPtr.IsValid())
+	{
+		StatsPtr = MakeUnique<FInstanceStats>();
+	}
+	
+	FInstanceStats& Stats = *StatsPtr;
+	if (Stats.Name.IsEmpty())
+	{
+		const UActorComponent* Component = Cast<UActorComponent>(Target);
+		Stats.Name = Component != nullptr && Component->GetOwner() != nullptr
+			? FString::Printf(TEXT("%s.%s"), *Component->GetOwner()->GetName(), *Component->GetName())
+			: Target->GetName();
+		Stats.Class = Target->GetClass();
+	}
+	Stats.TickGroup = TickFunction.TickGroup;
+
+	TUniquePtr<FProfiledTickFunction> Proxy = MakeUnique<FProfiledTickFunction>(*this, TickFunction, Target, Stats);
+	Proxy->Level = Level;
+	
+	TickFunction.UnRegisterTickFunction();
+	Proxy->RegisterTickFunction(Level);
+	
+	Proxies.Add(&TickFunction, MoveTemp(Proxy));
+}
+
+void UE::Automation::FTickProfiler::UpdatePrerequisites()
+{
+	// mirror original prerequisites, pointing to proxies instead of unregistered originals
+	for (TPair<FTickFunction*, TUniquePtr<FProfiledTickFunction>>& Pair: Proxies)
+	{
+		FProfiledTickFunction& Proxy = *Pair.Value;
+		if (!Proxy.Target.IsValid())
+		{
+			continue;
+		}
+
+		Proxy.GetPrerequisites().Reset();
+		for (const FTickPrerequisite& Prerequisite: Pair.Key->GetPrerequisites())
+		{
+			UObject* PrerequisiteObject = Prerequisite.PrerequisiteObject.Get();
+			FTickFunction* PrerequisiteFunction = Prerequisite.Get();
+			if (PrerequisiteObject == nullptr || PrerequisiteFunction == nullptr)
+			{
+				continue;
+			}
+
+			if (TUniquePtr<FProfiledTickFunction>* PrerequisiteProxy = Proxies.Find(PrerequisiteFunction))
+			{
+				Proxy.AddPrerequisite(PrerequisiteObject, **PrerequisiteProxy);
+			}
+			else
+			{
+				Proxy.AddPrerequisite(PrerequisiteObject, *PrerequisiteFunction);
+			}
+		}
+	}
+}
+
+void UE::Automation::FTickProfiler::RestoreTickFunctions()
+{
+	for (TPair<FTickFunction*, TUniquePtr<FProfiledTickFunction>>& Pair: Proxies)
+	{
+		FProfiledTickFunction& Proxy = *Pair.Value;
+		Proxy.UnRegisterTickFunction();
+
+		// re-register original tick function only if target is alive and didn't unregister its tick on its own
+		ULevel* Level = Proxy.Level.Get();
+		if (Proxy.Target.IsValid() && Level != nullptr && !Pair.Key->IsTickFunctionRegistered())
+		{
+			const UObject* Target = Proxy.Target.Get();
+			const bool bRegistered = Target->IsA<AActor>() ? !CastChecked<AActor>(Target)->IsActorBeingDestroyed() : CastChecked<UActorComponent>(Target)->IsRegistered();
+			if (bRegistered)
+			{
+				Pair.Key->RegisterTickFunction(Level);
+			}
+		}
+	}
+
+	Proxies.Reset();
+}
+
+void UE::Automation::FTickProfiler::SetWorld(UWorld* InWorld)
+{
+	check(InWorld);
+	RestoreTickFunctions();
+	World = InWorld;
+}
+
+void UE::Automation::FTickProfiler::ResetStats()
+{
+	for (TPair<FObjectKey, TUniquePtr<FInstanceStats>>& Pair: Instances)
+	{
+		Pair.Value->TotalCycles = 0;
+		Pair.Value->NumTicks = 0;
+		Pair.Value->FrameCycles = 0;
+		Pair.Value->Frame = INDEX_NONE;
+	}
+	NumFrames = 0;
+}
+
+TArray<UE::Automation::FTickProfileEntry> UE::Automation::FTickProfiler::GetTopInstances(int32 NumEntries) const
+{
+	TArray<FTickProfileEntry> Entries;
+	Entries.Reserve(Instances.Num());
+	
+	for (const TPair<FObjectKey, TUniquePtr<FInstanceStats>>& Pair: Instances)
+	{
+		const FInstanceStats& Stats = *Pair.Value;
+		if (Stats.NumTicks > 0)
+		{
+			const UClass* Class = Stats.Class.Get();
+			Entries.Add({Stats.Name, Stats.TickGroup, Class ? Class->GetFName() : NAME_None, FPlatformTime::ToMilliseconds64(Stats.TotalCycles), Stats.NumTicks});
+		}
+	}
+
+	Entries.Sort([](const FTickProfileEntry& Lhs, const FTickProfileEntry& Rhs) { return Lhs.TotalTimeMs > Rhs.TotalTimeMs; });
+	if (NumEntries >= 0 && Entries.Num() > NumEntries)
+	{
+		Entries.SetNum(NumEntries);
+	}
+	
+	return Entries;
+}
+
+TArray<UE::Automation::FTickProfileEntry> UE::Automation::FTickProfiler::GetTopInstancesInLastFrame(int32 NumEntries) const
+{
+	TArray<FTickProfileEntry> Entries;
+	for (const TPair<FObjectKey, TUniquePtr<FInstanceStats>>& Pair: Instances)
+	{
+		const FInstanceStats& Stats = *Pair.Value;
+		if (Stats.Frame == NumFrames && Stats.FrameCycles > 0)
+		{
+			const UClass* Class = Stats.Class.Get();
+			Entries.Add({Stats.Name, Stats.TickGroup, Class ? Class->GetFName() : NAME_None, FPlatformTime::ToMilliseconds64(Stats.FrameCycles), 1});
+		}
+	}
+
+	Entries.Sort([](const FTickProfileEntry& Lhs, const FTickProfileEntry& Rhs) { return Lhs.TotalTimeMs > Rhs.TotalTimeMs; });
+	if (NumEntries >= 0 && Entries.Num() > NumEntries)
+	{
+		Entries.SetNum(NumEntries);
+	}
+
+	return Entries;
+}
+
+TArray<UE::Automation::FTickProfileEntry> UE::Automation::FTickProfiler::GetTopClasses(int32 NumEntries) const
+{
+	TMap<FName, FTickProfileEntry> ClassEntries;
+	for (const TPair<FObjectKey, TUniquePtr<FInstanceStats>>& Pair: Instances)
+	{
+		const FInstanceStats& Stats = *Pair.Value;
+		const UClass* Class = Stats.Class.Get();
+		if (Stats.NumTicks == 0 || Class == nullptr)
+		{
+			continue;
+		}
+
+		FTickProfileEntry& Entry = ClassEntries.FindOrAdd(Class->GetFName());
+		Entry.Name = Class->GetName();
+		Entry.ClassName = Class->GetFName();
+		Entry.TotalTimeMs += FPlatformTime::ToMilliseconds64(Stats.TotalCycles);
+		Entry.NumTicks += Stats.NumTicks;
+	}
+
+	TArray<FTickProfileEntry> Entries;
+	ClassEntries.GenerateValueArray(Entries);
+	
+	Entries.Sort([](const FTickProfileEntry& Lhs, const FTickProfileEntry& Rhs) { return Lhs.TotalTimeMs > Rhs.TotalTimeMs; });
+	if (NumEntries >= 0 && Entries.Num() > NumEntries)
+	{
+		Entries.SetNum(NumEntries);
+	}
+
+	return Entries;
+}
+
+double UE::Automation::FTickProfiler::GetClassTickTimeMs(const UClass* Class) const
+{
+	check(Class);
+	
+	uint64 TotalCycles = 0;
+	for (const TPair<FObjectKey, TUniquePtr<FInstanceStats>>& Pair: Instances)
+	{
+		if (const UClass* InstanceClass = Pair.Value->Class.Get(); InstanceClass && InstanceClass->IsChildOf(Class))
+		{
+			TotalCycles += Pair.Value->TotalCycles;
+		}
+	}
+
+	return FPlatformTime::ToMilliseconds64(TotalCycles);
+}
@@ -0,0 +1,100 @@
+#include "AutomationTraceCapture.h"
+
+#include "CommonAutomationModule.h"
+#include "HAL/FileManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+#include "ProfilingDebugging/TraceAuxiliary.h"
+#include "Trace/Trace.h"
+
+namespace UE::Automation
+{
+	/** channels captured for automation world. Memory allocation channel can't be enabled after startup, so only memory tags are captured */
+	static const TCHAR* CapturedChannels[] = {TEXT("cpu"), TEXT("loadtime"), TEXT("memtag")};
+}
+
+UE::Automation::FTraceCapture::FTraceCapture(double InBudgetSeconds)
+	: StartTime(FPlatformTime::Seconds())
+	, BudgetSeconds(InBudgetSeconds)
+{
+#if UE_TRACE_ENABLED
+	for (const TCHAR* Channel: CapturedChannels)
+	{
+		const Trace::FChannel* TraceChannel = Trace::FChannel::FindChannel(TCHAR_TO_ANSI(Channel));
+		if (TraceChannel != nullptr && !TraceChannel->IsEnabled() && Trace::ToggleChannel(Channel, true))
+		{
+			EnabledChannels.Add(Channel);
+		}
+	}
+#endif
+}
+
+UE::Automation::FTraceCapture::~FTraceCapture()
+{
+#if UE_TRACE_ENABLED
+	for (const FString& Channel: EnabledChannels)
+	{
+		Trace::ToggleChannel(*Channel, false);
+	}
+#endif
+}
+
+void UE::Automation::FTraceCapture::MarkHitch(uint64 Frame)
+{
+	if (!bHitched)
+	{
+		bHitched = true;
+		FirstHitchFrame = Frame;
+	}
+}
+
+bool UE::Automation::FTraceCapture::ShouldWrite() const
+{
+	return bHitched || (BudgetSeconds > 0.0 && FPlatformTime::Seconds() - StartTime > BudgetSeconds);
+}
+
+FString UE::Automation::FTraceCapture::Finish(const FString& TestName)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FTraceCapture_Finish);
+	
+	if (bFinished)
+	{
+		return {};
+	}
+	bFinished = true;
+
+#if UE_TRACE_ENABLED
+	if (!ShouldWrite() || FTraceAuxiliary::IsConnected())
+	{
+		return {};
+	}
+
+	const FString FileName = FPaths::MakeValidFileName(TestName.IsEmpty() ? TEXT("AutomationWorld") : TestName, TEXT('_'));
+	const FString TracePath = GetTraceDirectory() / FString::Printf(TEXT("%s_%s.utrace"), *FileName, *FDateTime::Now().ToString());
+	IFileManager::Get().MakeDirectory(*GetTraceDirectory(), true);
+
+	if (!FTraceAuxiliary::WriteSnapshot(*TracePath))
+	{
+		UE_LOG(LogCommonAutomation, Warning, TEXT("%s: failed to write trace snapshot to %s"), *FString(__FUNCTION__), *TracePath);
+		return {};
+	}
+
+	if (bHitched)
+	{
+		UE_LOG(LogCommonAutomation, Display, TEXT("%s: world hitched at frame %llu, trace written to %s"), *FString(__FUNCTION__), FirstHitchFrame, *TracePath);
+	}
+	else
+	{
+		UE_LOG(LogCommonAutomation, Display, TEXT("%s: exceeded time budget of %.2fs, trace written to %s"), *FString(__FUNCTION__), BudgetSeconds, *TracePath);
+	}
+	
+	return TracePath;
+#else
+	return {};
+#endif
+}
+
+FString UE::Automation::FTraceCapture::GetTraceDirectory()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Automation") / TEXT("Traces");
+}
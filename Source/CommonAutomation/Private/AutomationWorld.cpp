@@ -1,24 +1,55 @@
 ﻿#include "AutomationWorld.h"
 
+#include "AutomationActorDescQuery.h"
+#include "AutomationAssetStubs.h"
 #include "AutomationCommon.h"
+#include "AutomationFrameTiming.h"
 #include "AutomationGameInstance.h"
+#include "AutomationLoadManifest.h"
+#include "AutomationLoadTracker.h"
+#include "AutomationPerfHistory.h"
+#include "AutomationSyncLoadDetector.h"
+#include "AutomationTestDependencies.h"
+#include "AutomationTickProfiler.h"
+#include "AutomationTraceCapture.h"
+#include "AutomationWorldTask.h"
+#include "AutomationWorldUsage.h"
 #include "CommonAutomationModule.h"
 #include "CommonAutomationSettings.h"
 #include "DummyViewport.h"
+#include "EngineModule.h"
 #include "EngineUtils.h"
 #include "GameInstanceAutomationSupport.h"
 #include "GameMapsSettings.h"
-#include "PackageTools.h"
+#include "RendererInterface.h"
+#include "SceneInterface.h"
 #include "AI/NavigationSystemBase.h"
 #include "AssetRegistry/AssetRegistryHelpers.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/LevelScriptActor.h"
 #include "Engine/LocalPlayer.h"
 #include "GameFramework/GameModeBase.h"
+#include "GameFramework/WorldSettings.h"
 #include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
 #include "Streaming/LevelStreamingDelegates.h"
 #include "Subsystems/LocalPlayerSubsystem.h"
 #include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/DataLayer/DataLayerAsset.h"
+#include "WorldPartition/DataLayer/DataLayerInstance.h"
+#include "WorldPartition/DataLayer/DataLayerManager.h"
+#include "WorldPartition/DataLayer/WorldDataLayers.h"
+#if WITH_EDITOR
+#include "DataLayer/DataLayerEditorSubsystem.h"
+#include "WorldPartition/WorldPartitionActorDescInstance.h"
+#include "WorldPartition/WorldPartitionEditorLoaderAdapter.h"
+#include "WorldPartition/WorldPartitionHelpers.h"
 #include "WorldPartition/WorldPartitionLevelHelper.h"
+#include "WorldPartition/LoaderAdapter/LoaderAdapterActorList.h"
+#include "WorldPartition/LoaderAdapter/LoaderAdapterShape.h"
 #include "WorldPartition/ErrorHandling/WorldPartitionStreamingGenerationLogErrorHandler.h"
+#endif
 
 static bool GRunGarbageCollectionForEveryWorld = false;
 static FAutoConsoleVariableRef RunGarbageCollectionForEveryWorld(
@@ -27,6 +58,114 @@ static FAutoConsoleVariableRef RunGarbageCollectionForEveryWorld(
 	TEXT("If set, garbage collection runs every time automation world is destroyed")
 );
 
+static int32 GProfileTicks = 0;
+static FAutoConsoleVariableRef ProfileTicks(
+	TEXT("CommonAutomation.ProfileTicks"),
+	GProfileTicks,
+	TEXT("If greater than zero, every automation world profiles actor and component ticks and reports specified number of top entries when destroyed")
+);
+
+static int32 GFrameTimingCapacity = 1024;
+static FAutoConsoleVariableRef FrameTimingCapacity(
+	TEXT("CommonAutomation.FrameTimingCapacity"),
+	GFrameTimingCapacity,
+	TEXT("Number of frames kept in automation world frame timing buffer")
+);
+
+static float GHitchThresholdMs = 0.f;
+static FAutoConsoleVariableRef HitchThresholdMs(
+	TEXT("CommonAutomation.HitchThresholdMs"),
+	GHitchThresholdMs,
+	TEXT("If greater than zero, every automation world records frames that take longer than specified time and reports them when destroyed")
+);
+
+static bool GTraceCapture = false;
+static FAutoConsoleVariableRef TraceCapture(
+	TEXT("CommonAutomation.TraceCapture"),
+	GTraceCapture,
+	TEXT("If set, every automation world keeps trace events in memory and writes them to Saved/Automation/Traces if world exceeds time budget or hitches")
+);
+
+static float GTraceBudgetSeconds = 0.f;
+static FAutoConsoleVariableRef TraceBudgetSeconds(
+	TEXT("CommonAutomation.TraceBudgetSeconds"),
+	GTraceBudgetSeconds,
+	TEXT("Automation world time budget for CommonAutomation.TraceCapture. If zero, trace is written only on hitches")
+);
+
+static bool GRecordPerfHistory = false;
+static FAutoConsoleVariableRef RecordPerfHistory(
+	TEXT("CommonAutomation.PerfHistory"),
+	GRecordPerfHistory,
+	TEXT("If set, every automation world appends its metrics to Saved/Automation/PerfHistory.bin and reports regressions against previous runs of the same test")
+);
+
+static int32 GPerfHistoryWindow = 20;
+static FAutoConsoleVariableRef PerfHistoryWindow(
+	TEXT("CommonAutomation.PerfHistoryWindow"),
+	GPerfHistoryWindow,
+	TEXT("Number of previous performance history entries automation world metrics are compared against")
+);
+
+static int32 GProbeInitFlags = 0;
+static FAutoConsoleVariableRef ProbeInitFlags(
+	TEXT("CommonAutomation.ProbeInitFlags"),
+	GProbeInitFlags,
+	TEXT("1: every automation world reports minimal init flags for observed usage. 2: also fail tests that request CommonAutomation.ProbeInitFlagsMaxUnused or more unused flags and subsystems")
+);
+
+static int32 GProbeInitFlagsMaxUnused = 3;
+static FAutoConsoleVariableRef ProbeInitFlagsMaxUnused(
+	TEXT("CommonAutomation.ProbeInitFlagsMaxUnused"),
+	GProbeInitFlagsMaxUnused,
+	TEXT("Number of unused init flags and subsystems that fails the test if CommonAutomation.ProbeInitFlags is 2")
+);
+
+static bool GTrackTestDependencies = false;
+static FAutoConsoleVariableRef TrackTestDependencies(
+	TEXT("CommonAutomation.TrackTestDependencies"),
+	GTrackTestDependencies,
+	TEXT("If set, packages loaded and classes instantiated by automation worlds are recorded per test to Saved/Automation/TestDependencies.json, @see CommonAutomationSelectTests commandlet")
+);
+
+static bool GPreloadLoadManifests = false;
+static FAutoConsoleVariableRef PreloadLoadManifests(
+	TEXT("CommonAutomation.PreloadLoadManifests"),
+	GPreloadLoadManifests,
+	TEXT("If set, packages loaded during automation world creation are saved as a per-test manifest and preloaded with parallel async loads before the world is created on the next run")
+);
+
+static int32 GDetectSyncLoads = 0;
+static FAutoConsoleVariableRef DetectSyncLoads(
+	TEXT("CommonAutomation.DetectSyncLoads"),
+	GDetectSyncLoads,
+	TEXT("Report synchronous package loads made while automation world ticks. 0 - disabled, 1 - report as warnings, 2 - report as errors")
+);
+
+static bool GAttributeSyncLoads = false;
+static FAutoConsoleVariableRef AttributeSyncLoads(
+	TEXT("CommonAutomation.AttributeSyncLoads"),
+	GAttributeSyncLoads,
+	TEXT("If set, detected synchronous loads are attributed to ticking actors and components. Starts tick profiling, which replaces world tick functions with proxies")
+);
+
+/** attribute packages loaded inside the scope to a load phase */
+struct FScopeLoadPhase
+{
+	FScopeLoadPhase(UE::Automation::FPackageLoadTracker& InTracker, UE::Automation::ELoadPhase Phase)
+		: Tracker(InTracker)
+		, PrevPhase(InTracker.SetPhase(Phase))
+	{}
+
+	~FScopeLoadPhase()
+	{
+		Tracker.SetPhase(PrevPhase);
+	}
+
+	UE::Automation::FPackageLoadTracker& Tracker;
+	UE::Automation::ELoadPhase PrevPhase;
+};
+
 template <typename TSubsystemType>
 struct FScopeDisableSubsystemCreation
 {
@@ -78,6 +217,7 @@ FObjectSubsystemCollection<TSubsystemType>* GetSubsystemCollection(T* Owner)
 	return reinterpret_cast<TCollectionType*>(reinterpret_cast<uint8*>(Owner) + CollectionOffset);
 }
 
+#if WITH_EDITOR
 namespace UE::Automation
 {
 	void RemapLevelSoftObjectPaths(ULevel* Level, UWorldPartition* WorldPartition)
@@ -92,7 +232,7 @@ namespace UE::Automation
 		FixupSerializer.Fixup(Level);
 	}
 }
-
+#endif
 
 const FAutomationWorldInitParams FAutomationWorldInitParams::Minimal{EWorldType::Game, EWorldInitFlags::Minimal};
 const FAutomationWorldInitParams FAutomationWorldInitParams::WithBeginPlay{EWorldType::Game, EWorldInitFlags::WithBeginPlay};
@@ -135,7 +275,15 @@ bool FAutomationWorldInitParams::ShouldInitScene() const
 {
 	constexpr EWorldInitFlags ShouldInitScene = EWorldInitFlags::InitScene | EWorldInitFlags::InitPhysics | EWorldInitFlags::InitWeldedBodies |
 												EWorldInitFlags::InitHitProxy | EWorldInitFlags::InitCollision | EWorldInitFlags::InitFX;
-	return !!(InitFlags & ShouldInitScene);
+	return !!(InitFlags & ShouldInitScene) && !ShouldDeferScene();
+}
+
+bool FAutomationWorldInitParams::ShouldDeferScene() const
+{
+	// hit proxies, FX system and physics scene are created together with the scene, world init skips them all if scene is deferred
+	constexpr EWorldInitFlags RequireSceneOnInit = EWorldInitFlags::InitHitProxy | EWorldInitFlags::InitFX | EWorldInitFlags::InitPhysics |
+												   EWorldInitFlags::InitCollision | EWorldInitFlags::InitWeldedBodies;
+	return !!(InitFlags & EWorldInitFlags::LazyScene) && !(InitFlags & RequireSceneOnInit);
 }
 
 bool FAutomationWorldInitParams::ShouldInitWorldPartition() const
@@ -144,6 +292,119 @@ bool FAutomationWorldInitParams::ShouldInitWorldPartition() const
 	return !!(InitFlags & ShouldInitWorldPartition);
 }
 
+bool FAutomationWorldInitParams::ShouldLoadActor(const AActor* Actor) const
+{
+	check(Actor);
+	// actors required by level itself
+	if (Actor->IsA<AWorldSettings>() || Actor->IsA<ALevelScriptActor>() || Actor->IsA<AWorldDataLayers>() || Actor == Actor->GetLevel()->GetDefaultBrush())
+	{
+		return true;
+	}
+
+	return ShouldLoadActorClass(Actor->GetClass());
+}
+
+bool FAutomationWorldInitParams::ShouldLoadActorClass(const UClass* ActorClass) const
+{
+	check(ActorClass);
+	auto IsChildOf = [ActorClass](const UClass* Class) { return ActorClass->IsChildOf(Class); };
+	
+	if (ExcludeActorClasses.ContainsByPredicate(IsChildOf))
+	{
+		return false;
+	}
+
+	return IncludeActorClasses.IsEmpty() || IncludeActorClasses.ContainsByPredicate(IsChildOf);
+}
+
+const EDataLayerRuntimeState* FAutomationWorldInitParams::FindDataLayerState(const UDataLayerInstance* DataLayer, FName* OutDataLayer) const
+{
+	check(DataLayer);
+	const UDataLayerAsset* DataLayerAsset = DataLayer->GetAsset();
+	const FString ShortName = DataLayer->GetDataLayerShortName();
+	const FString FullName = DataLayer->GetDataLayerFullName();
+	
+	for (const TPair<FName, EDataLayerRuntimeState>& DataLayerState: DataLayerStates)
+	{
+		const FName Name = DataLayerState.Key;
+		if (Name == DataLayer->GetDataLayerFName() || (DataLayerAsset != nullptr && Name == DataLayerAsset->GetFName()) ||
+			ShortName == Name.ToString() || FullName == Name.ToString())
+		{
+			if (OutDataLayer != nullptr)
+			{
+				*OutDataLayer = Name;
+			}
+			return &DataLayerState.Value;
+		}
+	}
+
+	return nullptr;
+}
+
+TArray<FName> FAutomationWorldInitParams::GatherExternalActorDependencies() const
+{
+#if WITH_EDITOR
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorldInitParams_GatherExternalActorDependencies);
+	if (!HasWorldPackage())
+	{
+		return {};
+	}
+	
+	const IAssetRegistry& AssetRegistry = IAssetRegistry::GetChecked();
+	const FName WorldPackageName{GetWorldPackage()};
+
+	TArray<FAssetData> WorldAssets;
+	AssetRegistry.GetAssetsByPackageName(WorldPackageName, WorldAssets);
+	const FAssetData* WorldAsset = WorldAssets.FindByPredicate([](const FAssetData& Asset) { return Asset.AssetClassPath == UWorld::StaticClass()->GetClassPathName(); });
+	if (WorldAsset == nullptr || !ULevel::GetIsLevelUsingExternalActorsFromAsset(*WorldAsset))
+	{
+		return {};
+	}
+
+	// one file per actor levels load every actor. World partition loads always loaded actors, and actors of load regions for editor worlds.
+	// Game world cells are selected by streaming sources once world begins play, so only always loaded actors are known in advance
+	const bool bLoadAllActors = !ULevel::GetIsLevelPartitionedFromAsset(*WorldAsset) || !!(InitFlags & EWorldInitFlags::DisableStreaming);
+	const TConstArrayView<FBox> Regions = IsEditorWorld() ? TConstArrayView<FBox>{LoadRegions} : TConstArrayView<FBox>{};
+	
+	TArray<FName> ActorPackages;
+	UE::Automation::FActorDescQuery::ForEach(WorldPackageName, {}, [this, bLoadAllActors, Regions, &ActorPackages](const UE::Automation::FActorDescInfo& ActorDesc)
+	{
+		const bool bLoadedWithWorld = bLoadAllActors || !ActorDesc.bIsSpatiallyLoaded ||
+			Regions.ContainsByPredicate([&ActorDesc](const FBox& Region) { return Region.Intersect(ActorDesc.Bounds); });
+		
+		const UClass* NativeClass = FindObject<UClass>(ActorDesc.NativeClass);
+		if (bLoadedWithWorld && (NativeClass == nullptr || ShouldLoadActorClass(NativeClass)))
+		{
+			ActorPackages.Add(ActorDesc.ActorPackage);
+		}
+		return true;
+	});
+
+	const FString ExternalActorsPath = ULevel::GetExternalActorsPath(WorldPackageName.ToString());
+	TSet<FName> Dependencies;
+	TArray<FName> ActorDependencies;
+	for (const FName ActorPackage: ActorPackages)
+	{
+		ActorDependencies.Reset();
+		AssetRegistry.GetDependencies(ActorPackage, ActorDependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+		for (const FName Dependency: ActorDependencies)
+		{
+			const FNameBuilder DependencyName{Dependency};
+			if (Dependency != WorldPackageName && UE::Automation::FLoadManifest::CanPreload(Dependency) && !DependencyName.ToView().StartsWith(ExternalActorsPath))
+			{
+				Dependencies.Add(Dependency);
+			}
+		}
+	}
+
+	UE_LOG(LogCommonAutomation, Verbose, TEXT("%s: %d external actors of %s depend on %d packages"), *FString(__FUNCTION__), ActorPackages.Num(), *WorldPackageName.ToString(), Dependencies.Num());
+	return Dependencies.Array();
+#else
+	// cooked external actors are loaded by cells in batches already
+	return {};
+#endif
+}
+
 FAutomationWorldPtr FAutomationWorldInitParams::Create() const
 {
 	return FAutomationWorld::CreateWorld(*this);
@@ -153,8 +414,9 @@ bool FAutomationWorld::bExists = false;
 UGameInstance* FAutomationWorld::SharedGameInstance = nullptr;
 
 
-FAutomationWorld::FAutomationWorld(UWorld* InWorld, const FAutomationWorldInitParams& InitParams)
+FAutomationWorld::FAutomationWorld(UWorld* InWorld, const FAutomationWorldInitParams& InitParams, TUniquePtr<UE::Automation::FPackageLoadTracker>&& InLoadTracker)
 	: CachedInitParams(InitParams)
+	, LoadTracker(MoveTemp(InLoadTracker))
 {
 	bExists = true;
 	InitialFrameCounter = GFrameCounter;
@@ -164,11 +426,15 @@ FAutomationWorld::FAutomationWorld(UWorld* InWorld, const FAutomationWorldInitPa
 
 	StreamingStateHandle = FLevelStreamingDelegates::OnLevelStreamingStateChanged.AddRaw(this, &FAutomationWorld::HandleLevelStreamingStateChange);
 
+	FrameTimings = MakeUnique<UE::Automation::FFrameTimingRecorder>(GFrameTimingCapacity);
+	FrameTimings->SetHitchThreshold(GHitchThresholdMs);
+
 	// create game instance if it was requested by user. Game instance is required for game mode
 	// @note: use fallback game instance to create game mode? Don't create game instance if not explicitly specified?
 	if (InitParams.CreateGameInstance() || InitParams.DefaultGameMode != nullptr)
 	{
 		check(InitParams.WorldType == EWorldType::Game);
+		FScopeLoadPhase LoadPhase{*LoadTracker, UE::Automation::ELoadPhase::GameMode};
 		CreateGameInstance(InitParams);
 	}
 
@@ -182,6 +448,7 @@ FAutomationWorld::FAutomationWorld(UWorld* InWorld, const FAutomationWorldInitPa
 		CreateViewportClient();
 	}
 
+	LoadTracker->SetPhase(UE::Automation::ELoadPhase::BeginPlay);
 	// conditionally start play
 	if (InitParams.RouteStartPlay())
 	{
@@ -194,12 +461,34 @@ FAutomationWorld::FAutomationWorld(UWorld* InWorld, const FAutomationWorldInitPa
 	{
 		GetOrCreatePrimaryPlayer();
 	}
+	LoadTracker->SetPhase(UE::Automation::ELoadPhase::Runtime);
+
+	if (GProfileTicks > 0)
+	{
+		StartTickProfiling();
+	}
+
+	if (GProbeInitFlags > 0)
+	{
+		StartUsageProbe();
+	}
+
+	if (GDetectSyncLoads > 0)
+	{
+		StartSyncLoadDetection(GDetectSyncLoads > 1 ? UE::Automation::ESyncLoadPolicy::Error : UE::Automation::ESyncLoadPolicy::Warning, GAttributeSyncLoads);
+	}
 
 	TestCompletedHandle = FAutomationTestFramework::Get().OnTestEndEvent.AddRaw(this, &FAutomationWorld::HandleTestCompleted);
 }
 
 void FAutomationWorld::HandleTestCompleted(FAutomationTestBase* Test)
 {
+	if (FixtureTest != nullptr && FixtureTest == Test)
+	{
+		// fixture world outlives a single test run, safety check is performed by the fixture
+		return;
+	}
+	
 	UE_LOG(LogCommonAutomation, Fatal, TEXT("Automation world wasn't destroyed at the end of the test %s"), *Test->GetBeautifiedTestName());
 }
 
@@ -285,9 +574,18 @@ void FAutomationWorld::InitializeNewWorld(UWorld* InWorld, const FAutomationWorl
 	{
 		InitializeWorldPartition(World);
 	}
+
+	// apply before the first streaming update, so that cells of unloaded data layers are never loaded
+	ApplyDataLayerStates();
+	// load regions after data layer states are set, loader adapters skip actors of data layers not loaded in editor
+	LoadEditorRegions();
+
+	// filter after world partition is initialized, editor worlds load always loaded actors during initialization
+	FilterLevelActors(World->PersistentLevel);
 	
 	if (GameInstance != nullptr)
 	{
+		FScopeLoadPhase LoadPhase{*LoadTracker, UE::Automation::ELoadPhase::GameMode};
 		World->SetGameMode({});
 	}
 	
@@ -297,6 +595,16 @@ void FAutomationWorld::InitializeNewWorld(UWorld* InWorld, const FAutomationWorl
 	// Make sure secondary levels are loaded & visible.
 	World->FlushLevelStreaming();
 
+	if (InitParams.ShouldDeferScene())
+	{
+		// create scene once the first visible primitive is registered. Until then, component registration skips render state
+		UpdateDeferredScene();
+		if (World->Scene == nullptr)
+		{
+			ComponentRegisteredHandle = UActorComponent::GlobalRegisterComponentDelegate.AddRaw(this, &FAutomationWorld::HandleComponentRegistered);
+		}
+	}
+
 	// Step 2025: separately initialize navigation system, because apparently it is not a part of world initialization
 	// For editor, PIE and game worlds it is initialized separately, either in game instance, editor or game engine
 	if (IsEditorWorld() && !!(CachedInitParams.InitFlags & EWorldInitFlags::InitNavigation))
@@ -314,6 +622,8 @@ void FAutomationWorld::InitializeWorldPartition(UWorld* InWorld)
 		return;
 	}
 	
+	// streaming is generated on the fly for uncooked worlds, cooked worlds already contain generated streaming cells
+#if WITH_EDITOR
 	UWorldPartition* WorldPartition = InWorld->GetWorldPartition();
 	if (WorldPartition == nullptr)
 	{
@@ -343,6 +653,7 @@ void FAutomationWorld::InitializeWorldPartition(UWorld* InWorld)
 	// Apply remapping of Persistent Level's SoftObjectPaths
 	// Here we remap SoftObjectPaths so that they are mapped from the PersistentLevel Package to the Cell Packages using the mapping built by the policy
 	UE::Automation::RemapLevelSoftObjectPaths(World->PersistentLevel, WorldPartition);
+#endif
 }
 
 void FAutomationWorld::CreateGameInstance(const FAutomationWorldInitParams& InitParams)
@@ -438,6 +749,12 @@ void FAutomationWorld::HandleLevelStreamingStateChange(UWorld* OtherWorld, const
 		return;
 	}
 	
+	if (LevelIfLoaded && NewState == ELevelStreamingState::LoadedNotVisible)
+	{
+		// level is loaded but not added to world yet, components of its actors are not registered
+		FilterLevelActors(LevelIfLoaded);
+	}
+	
 	if (LevelIfLoaded)
 	{
 #if WITH_EDITOR
@@ -461,8 +778,60 @@ FAutomationWorld::~FAutomationWorld()
 	
 	check(IsValid(World));
 	FLevelStreamingDelegates::OnLevelStreamingStateChanged.Remove(StreamingStateHandle);
+	UActorComponent::GlobalRegisterComponentDelegate.Remove(ComponentRegisteredHandle);
 	// remove test completion handle
 	FAutomationTestFramework::Get().OnTestEndEvent.Remove(TestCompletedHandle);
+
+	FAutomationTestBase* CurrentTest = FAutomationTestFramework::Get().GetCurrentTest();
+	const FString TestName = CurrentTest ? CurrentTest->GetTestFullName() : FString{};
+
+	if (GRecordPerfHistory && CurrentTest != nullptr)
+	{
+		RecordPerfHistory(CurrentTest);
+	}
+
+	// world teardown doesn't load anything test depends on
+	LoadTracker->Stop();
+	if (GTrackTestDependencies && CurrentTest != nullptr)
+	{
+		RecordTestDependencies(CurrentTest);
+	}
+
+	if (SyncLoadDetector.IsValid())
+	{
+		if (CurrentTest != nullptr)
+		{
+			ReportSyncLoads(CurrentTest);
+		}
+		SyncLoadDetector.Reset();
+	}
+
+	if (UsageProbe.IsValid())
+	{
+		UsageProbe->Sample(World);
+		if (CurrentTest != nullptr)
+		{
+			ReportUsage(CurrentTest);
+		}
+		UsageProbe.Reset();
+	}
+
+	if (TickProfiler.IsValid())
+	{
+		if (GProfileTicks > 0)
+		{
+			ReportTickProfile(GProfileTicks);
+		}
+		// restore original tick functions before world is destroyed
+		StopTickProfiling();
+	}
+
+	if (!FrameTimings->GetHitches().IsEmpty())
+	{
+		ReportFrameTimings();
+	}
+	// unregister tick group sentinels before world is destroyed
+	FrameTimings.Reset();
 	
 	if (World->GetBegunPlay())
 	{
@@ -480,6 +849,9 @@ FAutomationWorld::~FAutomationWorld()
 	World->DestroyWorld(false);
 	GEngine->DestroyWorldContext(World);
 
+	// suspended world tasks are never resumed after world is destroyed
+	TaskScheduler.Reset();
+	
 	// null pointers to subsystem collections
 	WorldCollection = nullptr;
 	GameInstanceCollection = nullptr;
@@ -498,6 +870,17 @@ FAutomationWorld::~FAutomationWorld()
 	// restore globals and garbage collect the world
 	GFrameCounter = InitialFrameCounter;
 	GWorld = PrevGWorld;
+
+	if (TraceCapture.IsValid())
+	{
+		// write trace after world is destroyed to include teardown cost
+		const FString TracePath = TraceCapture->Finish(TestName);
+		if (CurrentTest != nullptr && !TracePath.IsEmpty())
+		{
+			CurrentTest->AddInfo(FString::Printf(TEXT("Trace captured to %s"), *TracePath));
+		}
+		TraceCapture.Reset();
+	}
 	
 	FCommonAutomationModule::RequestGC();
 	if (GRunGarbageCollectionForEveryWorld)
@@ -521,12 +904,40 @@ FAutomationWorldPtr FAutomationWorld::CreateWorld(const FAutomationWorldInitPara
 
 	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorld_CreateWorld);
 
+#if !WITH_EDITOR
+	if (InitParams.WorldType == EWorldType::Editor)
+	{
+		UE_LOG(LogCommonAutomation, Error, TEXT("%s: Editor worlds are not supported in non-editor builds"), *FString(__FUNCTION__));
+		return nullptr;
+	}
+#endif
+
 	FAutomationTestBase* Test = FAutomationTestFramework::Get().GetCurrentTest();
 	check(Test);
+
+	// start capture before world package is loaded to include world creation cost, capture is handed to the world once it is created
+	TUniquePtr<UE::Automation::FTraceCapture> CreationTraceCapture = GTraceCapture ? MakeUnique<UE::Automation::FTraceCapture>(GTraceBudgetSeconds) : nullptr;
+	
+	const uint64 CreationStartCycles = FPlatformTime::Cycles64();
+	// used memory depends on tests that ran before, perf history records world's own increase
+	const uint64 CreationStartMemory = GRecordPerfHistory ? FPlatformMemory::GetStats().UsedPhysical : 0;
+
+	// start tracking before manifest packages and world package are loaded, loads are attributed to map load phase until world initializes game mode.
+	// Preloaded packages count towards load budgets, load cost and test dependencies the same way they would if world loaded them
+	TUniquePtr<UE::Automation::FPackageLoadTracker> LoadTracker = MakeUnique<UE::Automation::FPackageLoadTracker>(GTrackTestDependencies);
+
+	TArray<FName> LoadManifest;
+	if (GPreloadLoadManifests)
+	{
+		// issue recorded world dependencies as a single batch of async loads instead of serial loads during world creation
+		LoadManifest = UE::Automation::FLoadManifest::Load(Test->GetTestFullName());
+		UE::Automation::FLoadManifest::Preload(LoadManifest);
+	}
 	
 	const FString CurrentTestName = FAutomationTestFramework::Get().GetCurrentTest()->GetBeautifiedTestName();
 	
 	UWorld* NewWorld = nullptr;
+	TUniquePtr<UE::Automation::FAssetStubs> AssetStubs;
 	// load game world flow
 	if (InitParams.HasWorldPackage())
 	{
@@ -554,6 +965,7 @@ FAutomationWorldPtr FAutomationWorld::CreateWorld(const FAutomationWorldInitPara
 		}
 		
 		UPackage* WorldPackage = CreateUniqueWorldPackage(WorldPackageToLoad, CurrentTestName);
+		const FName UniquePackageName = WorldPackage->GetFName();
 
 		const FName WorldPackageName{WorldPackageToLoad};
 		UWorld::WorldTypePreLoadMap.FindOrAdd(WorldPackageName) = InitParams.WorldType;
@@ -562,13 +974,33 @@ FAutomationWorldPtr FAutomationWorld::CreateWorld(const FAutomationWorldInitPara
 		{
 			// create an instancing context that redirects external actors from the original world package to the temporary	
 			// see UEditorEngine::Map_Load when creating a new world from a template map, EditorServer.cpp 2541
-			const FString UniquePackageString = *WriteToString<256>(WorldPackage->GetFName(), TEXT("."), FPackageName::GetShortName(WorldPackage->GetFName()));
+			const FString UniquePackageString = *WriteToString<256>(UniquePackageName, TEXT("."), FPackageName::GetShortName(UniquePackageName));
 			const FString OrigPackageString = *WriteToString<256>(WorldPackageName, TEXT("."), FPackageName::GetShortName(WorldPackageName));
 			InstancingContext.AddPathMapping(FSoftObjectPath{OrigPackageString}, FSoftObjectPath{UniquePackageString});
 		}
+
+		if (!!(InitParams.InitFlags & EWorldInitFlags::StubAssets))
+		{
+			// traces and physics need mesh collision, render scene handles stubs without render data
+			const bool bKeepCollisionMeshes = !!(InitParams.InitFlags & EWorldInitFlags::InitCollision) || !!(InitParams.InitFlags & EWorldInitFlags::InitPhysics);
+			AssetStubs = MakeUnique<UE::Automation::FAssetStubs>(UE::Automation::FAssetStubs::GetDefaultStubClasses(), bKeepCollisionMeshes);
+			AssetStubs->AddStubs(WorldPackageName, InstancingContext);
+		}
+
+		if (!!(InitParams.InitFlags & EWorldInitFlags::PreloadExternalActorDependencies))
+		{
+			// external actor packages are instanced with the world package, so only their dependencies can be loaded in advance
+			TArray<FName> Dependencies = InitParams.GatherExternalActorDependencies();
+			if (AssetStubs.IsValid())
+			{
+				const TSet<FName> StubbedPackages{AssetStubs->GetStubbedPackages()};
+				Dependencies.RemoveAll([&StubbedPackages](const FName Package) { return StubbedPackages.Contains(Package); });
+			}
+			UE::Automation::FLoadManifest::Preload(Dependencies);
+		}
 		
 		// load world package as a temporary package with a different name
-		WorldPackage  = LoadPackage(WorldPackage, PackagePath, InitParams.LoadFlags, nullptr, &InstancingContext);
+		WorldPackage = LoadPackage(WorldPackage, PackagePath, InitParams.LoadFlags, nullptr, &InstancingContext);
 		
 		UWorld::WorldTypePreLoadMap.Remove(WorldPackageName);
 
@@ -606,7 +1038,40 @@ FAutomationWorldPtr FAutomationWorld::CreateWorld(const FAutomationWorldInitPara
 		return nullptr;
 	}
 
-	FAutomationWorldPtr AutomationWorld = MakeShareable(new FAutomationWorld(NewWorld, InitParams));
+	FAutomationWorldPtr AutomationWorld = MakeShareable(new FAutomationWorld(NewWorld, InitParams, MoveTemp(LoadTracker)));
+	AutomationWorld->CreationTimeMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - CreationStartCycles);
+	AutomationWorld->InitialUsedMemory = CreationStartMemory;
+	AutomationWorld->AssetStubs = MoveTemp(AssetStubs);
+	AutomationWorld->TraceCapture = MoveTemp(CreationTraceCapture);
+	AutomationWorld->SampleUsedMemory();
+
+	for (const UE::Automation::FLoadBudget& Budget: InitParams.LoadBudgets)
+	{
+		AutomationWorld->CheckLoadBudget(Budget);
+	}
+
+	if (GPreloadLoadManifests)
+	{
+		// drop packages that no longer exist and extend manifest with packages loaded during creation that weren't preloaded
+		const int32 NumManifestPackages = LoadManifest.Num();
+		LoadManifest.RemoveAll([](const FName Package) { return !UE::Automation::FLoadManifest::CanPreload(Package); });
+		const bool bPrunedManifest = LoadManifest.Num() < NumManifestPackages;
+		const TSet<FName> ManifestPackages{LoadManifest};
+		// tracker records world package by its original name, it is always instanced rather than preloaded
+		const FName WorldPackageName = InitParams.HasWorldPackage() ? FName{InitParams.GetWorldPackage()} : NAME_None;
+		for (const FName Package: AutomationWorld->LoadTracker->GetLoadedPackages())
+		{
+			if (Package != WorldPackageName && !ManifestPackages.Contains(Package) && UE::Automation::FLoadManifest::CanPreload(Package))
+			{
+				LoadManifest.Add(Package);
+			}
+		}
+		
+		if (bPrunedManifest || LoadManifest.Num() > ManifestPackages.Num())
+		{
+			UE::Automation::FLoadManifest::Save(Test->GetTestFullName(), LoadManifest);
+		}
+	}
 	
 	return AutomationWorld;
 }
@@ -676,6 +1141,7 @@ UGameInstanceSubsystem* FAutomationWorld::GetOrCreateSubsystem(TSubclassOf<UGame
 	check(World && World->bIsWorldInitialized);
 	check(GameInstanceCollection);
 	
+	NotifySubsystemAccessed(SubsystemClass);
 	if (GameInstance == nullptr || SubsystemClass->HasAnyClassFlags(CLASS_Abstract))
 	{
 		return nullptr;
@@ -704,6 +1170,7 @@ UWorldSubsystem* FAutomationWorld::GetOrCreateSubsystem(TSubclassOf<UWorldSubsys
 	check(World && World->bIsWorldInitialized);
 	check(WorldCollection);
 
+	NotifySubsystemAccessed(SubsystemClass);
 	if (SubsystemClass->HasAnyClassFlags(CLASS_Abstract))
 	{
 		return nullptr;
@@ -734,6 +1201,14 @@ UWorldSubsystem* FAutomationWorld::GetOrCreateSubsystem(TSubclassOf<UWorldSubsys
 	return Subsystem;
 }
 
+void FAutomationWorld::NotifySubsystemAccessed(const UClass* SubsystemClass) const
+{
+	if (UsageProbe.IsValid())
+	{
+		UsageProbe->NotifySubsystemAccessed(SubsystemClass);
+	}
+}
+
 USubsystem* FAutomationWorld::AddAndInitializeSubsystem(FSubsystemCollectionBase* Collection, TSubclassOf<USubsystem> SubsystemClass, UObject* Outer)
 {
 	// This relies on FSubsystemCollectionBase having following memory alignment:
@@ -899,14 +1374,32 @@ void FAutomationWorld::TickWorld(int32 NumFrames)
 	constexpr float DeltaTime = 1.0 / 60.0;
 	while (NumFrames > 0)
 	{
+		if (TickProfiler.IsValid())
+		{
+			// wrap tick functions registered since the last frame
+			TickProfiler->WrapTickFunctions();
+		}
+
+		if (SyncLoadDetector.IsValid())
+		{
+			// only loads made by the world are reported, world tasks resumed after the frame are test code
+			SyncLoadDetector->SetActive(true, TickedFrames + 1);
+		}
+		
+		const uint64 FrameStartCycles = FPlatformTime::Cycles64();
+		FrameTimings->BeginFrame(World);
+		
 		World->Tick(TickType, DeltaTime);
+		const uint64 WorldTickEndCycles = FPlatformTime::Cycles64();
 
+#if WITH_EDITOR
 		if (IsEditorWorld())
 		{
 			// Tick any editor FTickableEditorObject derived classes
 			FTickableEditorObject::TickObjects(DeltaTime);
 		}
 		else
+#endif
 		{
 			// tick streamable manager and other game tickable objects without world
 			// world-related tickable objects are processed during world tick
@@ -918,9 +1411,109 @@ void FAutomationWorld::TickWorld(int32 NumFrames)
 
 		// tick for FAsyncMixin
 		FTSTicker::GetCoreTicker().Tick(DeltaTime);
+		
+		if (SyncLoadDetector.IsValid())
+		{
+			SyncLoadDetector->SetActive(false);
+		}
 		++GFrameCounter;
 		--NumFrames;
+
+		++TickedFrames;
+		TickedTime += DeltaTime;
+
+		const uint64 FrameEndCycles = FPlatformTime::Cycles64();
+		UE::Automation::FFrameTiming Timing;
+		Timing.Frame = TickedFrames;
+		Timing.GameThreadMs = FPlatformTime::ToMilliseconds64(FrameEndCycles - FrameStartCycles);
+		Timing.WorldTickMs = FPlatformTime::ToMilliseconds64(WorldTickEndCycles - FrameStartCycles);
+		Timing.TickablesMs = FPlatformTime::ToMilliseconds64(FrameEndCycles - WorldTickEndCycles);
+		const int32 NumHitches = FrameTimings->GetHitches().Num();
+		FrameTimings->EndFrame(Timing, WorldTickEndCycles, TickProfiler.Get());
+		
+		if (TraceCapture.IsValid() && FrameTimings->GetHitches().Num() > NumHitches)
+		{
+			TraceCapture->MarkHitch(TickedFrames);
+		}
+		
+		if (TaskScheduler.IsValid())
+		{
+			// resume world tasks at the end of the frame
+			TaskScheduler->ProcessFrame(TickedFrames, TickedTime);
+		}
+	}
+
+	SampleUsedMemory();
+	
+	if (UsageProbe.IsValid())
+	{
+		UsageProbe->Sample(World);
+	}
+}
+
+TArray<AActor*> FAutomationWorld::SpawnActorsBatched(UClass* Class, TConstArrayView<FTransform> Transforms, FActorSpawnParameters SpawnParams, EBatchSpawnFlags Flags)
+{
+	check(World && Class);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorld_SpawnActors);
+
+	if (Transforms.Num() > 1)
+	{
+		// name collision for every actor after the first one
+		SpawnParams.Name = NAME_None;
+	}
+	SpawnParams.bDeferConstruction = true;
+
+	// navigation octree is updated once for the whole batch
+	FNavigationLockContext NavigationLock{World, ENavigationLockReason::Unknown};
+
+	// Pass 1: construct actors and their native components
+	TArray<AActor*> Actors;
+	TArray<int32> TransformIndices;
+	Actors.Reserve(Transforms.Num());
+	TransformIndices.Reserve(Transforms.Num());
+	for (int32 Index = 0; Index < Transforms.Num(); ++Index)
+	{
+		if (AActor* Actor = World->SpawnActor(Class, &Transforms[Index], SpawnParams))
+		{
+			Actors.Add(Actor);
+			TransformIndices.Add(Index);
+		}
+	}
+
+	TArray<UPrimitiveComponent*> SkippedOverlapComponents;
+	if (EnumHasAnyFlags(Flags, EBatchSpawnFlags::SkipOverlapUpdates))
+	{
+		for (AActor* Actor: Actors)
+		{
+			Actor->ForEachComponent<UPrimitiveComponent>(false, [&SkippedOverlapComponents](UPrimitiveComponent* Component)
+			{
+				if (Component->GetGenerateOverlapEvents())
+				{
+					Component->SetGenerateOverlapEvents(false);
+					SkippedOverlapComponents.Add(Component);
+				}
+			});
+		}
+	}
+
+	// Pass 2: run construction scripts, register deferred components and call BeginPlay
+	for (int32 Index = 0; Index < Actors.Num(); ++Index)
+	{
+		Actors[Index]->FinishSpawning(Transforms[TransformIndices[Index]]);
+	}
+
+	// restore overlap events without updating overlaps
+	for (UPrimitiveComponent* Component: SkippedOverlapComponents)
+	{
+		if (IsValid(Component))
+		{
+			Component->SetGenerateOverlapEvents(true);
+		}
 	}
+
+	// actors can be destroyed during construction or BeginPlay
+	Actors.RemoveAll([](const AActor* Actor) { return !IsValid(Actor); });
+	return Actors;
 }
 
 void FAutomationWorld::AbsoluteWorldTravel(TSoftObjectPtr<UWorld> WorldToTravel, TSubclassOf<AGameModeBase> GameModeClass, FString TravelOptions)
@@ -957,6 +1550,18 @@ void FAutomationWorld::FinishWorldTravel()
     	// can't travel from the world that hasn't begun play
     	RouteStartPlay();
     }
+
+	// traveled to world is initialized by the engine with a scene
+	UActorComponent::GlobalRegisterComponentDelegate.Remove(ComponentRegisteredHandle);
+	ComponentRegisteredHandle.Reset();
+	
+	if (TickProfiler.IsValid())
+	{
+		// restore tick functions of the world we're traveling from
+		TickProfiler->RestoreTickFunctions();
+	}
+	// tick group sentinels are registered again for the new world on the next frame
+	FrameTimings->UnregisterSentinels();
 	
 	{
 		// world partition requires PIE world type to initialize properly for absolute world travel in editor
@@ -976,11 +1581,549 @@ void FAutomationWorld::FinishWorldTravel()
 	
 	// update world collection pointer
 	WorldCollection = GetSubsystemCollection<UWorldSubsystem>(World);
+
+	if (TickProfiler.IsValid())
+	{
+		TickProfiler->SetWorld(World);
+	}
 }
 
-UWorld* FAutomationWorld::GetWorld() const
+void FAutomationWorld::StartTickProfiling()
 {
-	return World;
+	check(World);
+	if (!TickProfiler.IsValid())
+	{
+		TickProfiler = MakeUnique<UE::Automation::FTickProfiler>(World);
+	}
+	if (SyncLoadDetector.IsValid())
+	{
+		SyncLoadDetector->SetTickProfiler(TickProfiler.Get());
+	}
+}
+
+void FAutomationWorld::StopTickProfiling()
+{
+	if (SyncLoadDetector.IsValid())
+	{
+		SyncLoadDetector->SetTickProfiler(nullptr);
+	}
+	TickProfiler.Reset();
+}
+
+const UE::Automation::FTickProfiler* FAutomationWorld::GetTickProfiler() const
+{
+	return TickProfiler.Get();
+}
+
+void FAutomationWorld::ReportTickProfile(int32 NumEntries) const
+{
+	FAutomationTestBase* Test = FAutomationTestFramework::Get().GetCurrentTest();
+	if (Test == nullptr || !TickProfiler.IsValid())
+	{
+		return;
+	}
+
+	Test->AddInfo(FString::Printf(TEXT("Tick profile for %d frames, top classes:"), TickProfiler->GetNumFrames()));
+	for (const UE::Automation::FTickProfileEntry& Entry: TickProfiler->GetTopClasses(NumEntries))
+	{
+		Test->AddInfo(FString::Printf(TEXT("\t%s: %.3f ms total, %d ticks, %.4f ms avg"), *Entry.Name, Entry.TotalTimeMs, Entry.NumTicks, Entry.GetAverageTimeMs()));
+	}
+
+	Test->AddInfo(TEXT("Top instances:"));
+	for (const UE::Automation::FTickProfileEntry& Entry: TickProfiler->GetTopInstances(NumEntries))
+	{
+		Test->AddInfo(FString::Printf(TEXT("\t%s (%s): %.3f ms total, %d ticks, %.4f ms avg"), *Entry.Name, *Entry.ClassName.ToString(), Entry.TotalTimeMs, Entry.NumTicks, Entry.GetAverageTimeMs()));
+	}
+}
+
+const UE::Automation::FFrameTimingRecorder& FAutomationWorld::GetFrameTimings() const
+{
+	return *FrameTimings;
+}
+
+void FAutomationWorld::SetHitchThreshold(double ThresholdMs, bool bCaptureTickFunctions)
+{
+	FrameTimings->SetHitchThreshold(ThresholdMs);
+	if (ThresholdMs > 0.0 && bCaptureTickFunctions)
+	{
+		StartTickProfiling();
+	}
+}
+
+void FAutomationWorld::StartUsageProbe()
+{
+	if (!UsageProbe.IsValid())
+	{
+		UsageProbe = MakeUnique<UE::Automation::FWorldUsageProbe>(CachedInitParams);
+	}
+}
+
+const UE::Automation::FWorldUsageProbe* FAutomationWorld::GetUsageProbe() const
+{
+	return UsageProbe.Get();
+}
+
+const UE::Automation::FAssetStubs* FAutomationWorld::GetAssetStubs() const
+{
+	return AssetStubs.Get();
+}
+
+void FAutomationWorld::ReportUsage(FAutomationTestBase* Test) const
+{
+	using namespace UE::Automation;
+	check(UsageProbe.IsValid());
+
+	const EWorldInitFlags UnusedFlags = UsageProbe->GetUnusedFlags();
+	const TArray<UClass*> UnusedSubsystems = UsageProbe->GetUnusedSubsystems();
+	if (UnusedFlags == EWorldInitFlags::None && UnusedSubsystems.IsEmpty())
+	{
+		return;
+	}
+
+	TArray<FString> SubsystemNames;
+	for (const UClass* SubsystemClass: UnusedSubsystems)
+	{
+		SubsystemNames.Add(SubsystemClass->GetName());
+	}
+
+	Test->AddInfo(FString::Printf(TEXT("Automation world requested %s, observed usage requires %s. Unused flags: %s, unused subsystems: %s"),
+		*FWorldUsageProbe::FlagsToString(UsageProbe->GetRequestedFlags()),
+		*FWorldUsageProbe::FlagsToString(UsageProbe->GetRecommendedFlags()),
+		*FWorldUsageProbe::FlagsToString(UnusedFlags),
+		SubsystemNames.IsEmpty() ? TEXT("None") : *FString::Join(SubsystemNames, TEXT(", "))));
+	Test->AddInfo(FString::Printf(TEXT("Suggested init params: %s"), *UsageProbe->GetSuggestedInitParams()));
+
+	const int32 NumUnused = FMath::CountBits(static_cast<uint64>(UnusedFlags)) + UnusedSubsystems.Num();
+	if (GProbeInitFlags > 1 && NumUnused >= GProbeInitFlagsMaxUnused)
+	{
+		Test->AddError(FString::Printf(TEXT("Automation world requests %d init flags and subsystems it doesn't use, use %s instead"), NumUnused, *UsageProbe->GetSuggestedInitParams()));
+	}
+}
+
+void FAutomationWorld::SampleUsedMemory()
+{
+	if (GRecordPerfHistory)
+	{
+		PeakUsedMemory = FMath::Max<uint64>(PeakUsedMemory, FPlatformMemory::GetStats().UsedPhysical);
+	}
+}
+
+void FAutomationWorld::RecordPerfHistory(FAutomationTestBase* Test)
+{
+	using namespace UE::Automation;
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorld_RecordPerfHistory);
+
+	// history is loaded once and kept in sync with appended entries
+	static TOptional<FPerfHistory> History;
+	if (!History.IsSet())
+	{
+		History.Emplace();
+		History->Load();
+	}
+
+	SampleUsedMemory();
+	
+	FPerfHistoryEntry Entry;
+	Entry.TestName = Test->GetTestFullName();
+	Entry.Changelist = FPerfHistory::GetBuildChangelist();
+	Entry.BuildVersion = FApp::GetBuildVersion();
+	Entry.Timestamp = FDateTime::UtcNow();
+	Entry.WorldCreationMs = CreationTimeMs;
+	Entry.TickP50Ms = FrameTimings->GetPercentile(EFrameTimingStat::GameThread, 0.5);
+	Entry.TickP95Ms = FrameTimings->GetPercentile(EFrameTimingStat::GameThread, 0.95);
+	Entry.TickP99Ms = FrameTimings->GetPercentile(EFrameTimingStat::GameThread, 0.99);
+	Entry.PeakUsedMemoryDelta = PeakUsedMemory - FMath::Min(InitialUsedMemory, PeakUsedMemory);
+	// packages that were already resident or were collected during world lifetime don't affect the count
+	Entry.PackagesLoaded = LoadTracker->GetLoadedPackages().Num();
+	Entry.GarbageCollectionMs = FrameTimings->GetTotalGarbageCollectionMs();
+
+	const TArray<const FPerfHistoryEntry*> TestHistory = History->GetTestHistory(Entry.TestName, GPerfHistoryWindow);
+	for (const FPerfRegression& Regression: FPerfHistory::FindRegressions(Entry, TestHistory))
+	{
+		Test->AddWarning(FString::Printf(TEXT("Performance regression: %s is %.3f, history mean %.3f, stddev %.3f over %d runs"),
+			FPerfHistory::GetMetricName(Regression.Metric), Regression.Value, Regression.HistoryMean, Regression.HistoryStdDev, TestHistory.Num()));
+	}
+
+	History->Append(Entry);
+}
+
+void FAutomationWorld::RecordTestDependencies(FAutomationTestBase* Test) const
+{
+	using namespace UE::Automation;
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorld_RecordTestDependencies);
+
+	const FName WorldPackage = CachedInitParams.HasWorldPackage() ? FName{CachedInitParams.GetWorldPackage()} : NAME_None;
+	// keyed the same way test selection enumerates tests
+	FTestDependencyMap::GetSessionMap().Record(FTestDependencyMap::GetTestPath(*Test), Test->GetTestSourceFileName(), *LoadTracker, WorldPackage);
+}
+
+const UE::Automation::FPackageLoadTracker& FAutomationWorld::GetLoadTracker() const
+{
+	return *LoadTracker;
+}
+
+UE::Automation::FLoadPhaseStats FAutomationWorld::GetLoadStats(TOptional<UE::Automation::ELoadPhase> Phase) const
+{
+	return LoadTracker->GetPhaseStats(Phase);
+}
+
+bool FAutomationWorld::CheckLoadBudget(const UE::Automation::FLoadBudget& Budget) const
+{
+	const TArray<FString> Violations = LoadTracker->CheckBudget(Budget);
+	if (Violations.IsEmpty())
+	{
+		return true;
+	}
+	
+	FAutomationTestBase* CurrentTest = FAutomationTestFramework::Get().GetCurrentTest();
+	for (const FString& Violation: Violations)
+	{
+		CurrentTest->AddError(FString::Printf(TEXT("Load budget exceeded: %s"), *Violation));
+	}
+
+	return false;
+}
+
+void FAutomationWorld::ReportLoadCost(int32 NumPackages) const
+{
+	using namespace UE::Automation;
+	
+	FAutomationTestBase* CurrentTest = FAutomationTestFramework::Get().GetCurrentTest();
+	for (int32 Index = 0; Index < static_cast<int32>(ELoadPhase::Num); ++Index)
+	{
+		const ELoadPhase Phase = static_cast<ELoadPhase>(Index);
+		const FLoadPhaseStats Stats = LoadTracker->GetPhaseStats(Phase);
+		CurrentTest->AddInfo(FString::Printf(TEXT("%s: %d packages (%d sync, %d async), %.2f MB, %.2fms"),
+			LexToString(Phase), Stats.NumPackages, Stats.NumSyncPackages, Stats.NumAsyncPackages, Stats.NumBytes / (1024.0 * 1024.0), Stats.WallTimeMs));
+	}
+
+	for (const FPackageLoadCost& Cost: LoadTracker->GetHeaviestPackages(NumPackages))
+	{
+		CurrentTest->AddInfo(FString::Printf(TEXT("%s: %.2f KB, %s, %s"), *Cost.PackageName.ToString(), Cost.Bytes / 1024.0, LexToString(Cost.Phase), Cost.bSynchronous ? TEXT("sync") : TEXT("async")));
+	}
+}
+
+void FAutomationWorld::StartSyncLoadDetection(UE::Automation::ESyncLoadPolicy Policy, bool bAttributeRequesters)
+{
+	if (!SyncLoadDetector.IsValid())
+	{
+		SyncLoadDetector = MakeUnique<UE::Automation::FSyncLoadDetector>(Policy);
+	}
+	
+	if (bAttributeRequesters)
+	{
+		// tick profiler reports currently ticking object, but replaces tick functions with proxies
+		StartTickProfiling();
+	}
+	SyncLoadDetector->SetTickProfiler(TickProfiler.Get());
+}
+
+const UE::Automation::FSyncLoadDetector* FAutomationWorld::GetSyncLoadDetector() const
+{
+	return SyncLoadDetector.Get();
+}
+
+void FAutomationWorld::ReportSyncLoads(FAutomationTestBase* Test) const
+{
+	using namespace UE::Automation;
+	
+	for (const FSyncLoad& SyncLoad: SyncLoadDetector->GetSyncLoads())
+	{
+		const FString Message = FSyncLoadDetector::FormatSyncLoad(SyncLoad);
+		if (SyncLoadDetector->GetPolicy() == ESyncLoadPolicy::Error)
+		{
+			Test->AddError(Message);
+		}
+		else
+		{
+			Test->AddWarning(Message);
+		}
+	}
+}
+
+void FAutomationWorld::StartTraceCapture(double BudgetSeconds)
+{
+	if (!TraceCapture.IsValid())
+	{
+		TraceCapture = MakeUnique<UE::Automation::FTraceCapture>(BudgetSeconds);
+	}
+}
+
+void FAutomationWorld::ReportFrameTimings() const
+{
+	using namespace UE::Automation;
+	
+	FAutomationTestBase* Test = FAutomationTestFramework::Get().GetCurrentTest();
+	if (Test == nullptr || FrameTimings->Num() == 0)
+	{
+		return;
+	}
+
+	Test->AddInfo(FString::Printf(TEXT("Frame timings for %d frames (p50/p95/p99/max):"), FrameTimings->Num()));
+	const TPair<const TCHAR*, EFrameTimingStat> Stats[] = {
+		{TEXT("Game thread"),			EFrameTimingStat::GameThread},
+		{TEXT("World tick"),			EFrameTimingStat::WorldTick},
+		{TEXT("Tickables"),				EFrameTimingStat::Tickables},
+		{TEXT("Garbage collection"),	EFrameTimingStat::GarbageCollection},
+	};
+	for (const TPair<const TCHAR*, EFrameTimingStat>& Stat: Stats)
+	{
+		Test->AddInfo(FString::Printf(TEXT("\t%s: %.3f/%.3f/%.3f/%.3f ms"), Stat.Key,
+			FrameTimings->GetPercentile(Stat.Value, 0.5), FrameTimings->GetPercentile(Stat.Value, 0.95),
+			FrameTimings->GetPercentile(Stat.Value, 0.99), FrameTimings->GetMax(Stat.Value)));
+	}
+
+	for (const FFrameHitch& Hitch: FrameTimings->GetHitches())
+	{
+		const FString TickGroup = Hitch.SlowestTickGroup != TG_MAX ? UEnum::GetValueAsString(Hitch.SlowestTickGroup.GetValue()) : TEXT("unknown");
+		Test->AddInfo(FString::Printf(TEXT("Hitch at frame %llu: %.3f ms, slowest tick group %s"), Hitch.Timing.Frame, Hitch.Timing.GameThreadMs, *TickGroup));
+		for (const FTickProfileEntry& Entry: Hitch.TickFunctions)
+		{
+			Test->AddInfo(FString::Printf(TEXT("\t%s (%s): %.3f ms"), *Entry.Name, *Entry.ClassName.ToString(), Entry.TotalTimeMs));
+		}
+	}
+}
+
+UWorld* FAutomationWorld::GetWorld() const
+{
+	return World;
+}
+
+void FAutomationWorld::EnsureScene()
+{
+	check(World);
+	if (World->Scene != nullptr)
+	{
+		return;
+	}
+	
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorld_EnsureScene);
+	
+	UActorComponent::GlobalRegisterComponentDelegate.Remove(ComponentRegisteredHandle);
+	ComponentRegisteredHandle.Reset();
+
+	// scene registers itself with the world
+	FSceneInterface* Scene = GetRendererModule().AllocateScene(World, false, false, World->GetFeatureLevel());
+	World->Scene = Scene;
+
+	// create render state for components registered without a scene
+	for (TActorIterator<AActor> It{World}; It; ++It)
+	{
+		It->ForEachComponent(false, [](UActorComponent* Component)
+		{
+			if (Component->IsRegistered() && !Component->IsRenderStateCreated())
+			{
+				Component->RecreateRenderState_Concurrent();
+			}
+		});
+	}
+}
+
+void FAutomationWorld::HandleComponentRegistered(UActorComponent* Component)
+{
+	// delegate is global, components of other worlds are ignored
+	const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component);
+	if (Primitive != nullptr && Primitive->GetWorld() == World && Primitive->IsVisible())
+	{
+		EnsureScene();
+	}
+}
+
+void FAutomationWorld::UpdateDeferredScene()
+{
+	for (TActorIterator<AActor> It{World}; It && World->Scene == nullptr; ++It)
+	{
+		It->ForEachComponent<UPrimitiveComponent>(false, [this](UPrimitiveComponent* Primitive)
+		{
+			if (Primitive->IsRegistered() && World->Scene == nullptr)
+			{
+				HandleComponentRegistered(Primitive);
+			}
+		});
+	}
+}
+
+void FAutomationWorld::ApplyDataLayerStates()
+{
+	if (CachedInitParams.DataLayerStates.IsEmpty() && !CachedInitParams.bUnloadOtherDataLayers)
+	{
+		return;
+	}
+
+	UDataLayerManager* DataLayerManager = UDataLayerManager::GetDataLayerManager(World);
+	if (DataLayerManager == nullptr)
+	{
+		UE_LOG(LogCommonAutomation, Error, TEXT("%s: Data layer states are set for world %s without world partition"), *FString(__FUNCTION__), *World->GetName());
+		return;
+	}
+
+	TSet<FName> FoundDataLayers;
+	DataLayerManager->ForEachDataLayerInstance([this, DataLayerManager, &FoundDataLayers](UDataLayerInstance* DataLayer)
+	{
+		FName DataLayerName;
+		const EDataLayerRuntimeState* State = CachedInitParams.FindDataLayerState(DataLayer, &DataLayerName);
+		if (State == nullptr && !CachedInitParams.bUnloadOtherDataLayers)
+		{
+			return true;
+		}
+		
+		if (State != nullptr)
+		{
+			FoundDataLayers.Add(DataLayerName);
+		}
+		
+		const EDataLayerRuntimeState NewState = State != nullptr ? *State : EDataLayerRuntimeState::Unloaded;
+		if (IsEditorWorld())
+		{
+#if WITH_EDITOR
+			if (UDataLayerEditorSubsystem* DataLayerEditor = UDataLayerEditorSubsystem::Get())
+			{
+				DataLayerEditor->SetDataLayerIsLoadedInEditor(DataLayer, NewState != EDataLayerRuntimeState::Unloaded, false);
+			}
+#endif
+		}
+		else if (DataLayer->IsRuntime())
+		{
+			// editor data layers don't affect game worlds, their actors are always included
+			DataLayerManager->SetDataLayerInstanceRuntimeState(DataLayer, NewState);
+		}
+		
+		return true;
+	});
+
+	for (const TPair<FName, EDataLayerRuntimeState>& DataLayerState: CachedInitParams.DataLayerStates)
+	{
+		if (!FoundDataLayers.Contains(DataLayerState.Key))
+		{
+			UE_LOG(LogCommonAutomation, Error, TEXT("%s: Data layer %s not found in world %s"), *FString(__FUNCTION__), *DataLayerState.Key.ToString(), *World->GetName());
+		}
+	}
+}
+
+void FAutomationWorld::LoadEditorRegions()
+{
+	if (CachedInitParams.LoadRegions.IsEmpty() && CachedInitParams.LoadRegionActors.IsEmpty())
+	{
+		return;
+	}
+
+	if (!IsEditorWorld())
+	{
+		UE_LOG(LogCommonAutomation, Warning, TEXT("%s: Load regions are ignored for game world %s"), *FString(__FUNCTION__), *World->GetName());
+		return;
+	}
+
+#if WITH_EDITOR
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorld_LoadEditorRegions);
+	
+	UWorldPartition* WorldPartition = World->GetWorldPartition();
+	if (WorldPartition == nullptr)
+	{
+		UE_LOG(LogCommonAutomation, Error, TEXT("%s: Load regions are set for world %s without world partition"), *FString(__FUNCTION__), *World->GetName());
+		return;
+	}
+
+	TArray<FBox> Regions = CachedInitParams.LoadRegions;
+	if (!CachedInitParams.LoadRegionActors.IsEmpty())
+	{
+		// region actors are not necessarily loaded, take bounds from actor descriptors
+		TSet<FName> FoundActors;
+		FWorldPartitionHelpers::ForEachActorDescInstance(WorldPartition, AActor::StaticClass(), [this, &Regions, &FoundActors](const FWorldPartitionActorDescInstance* ActorDescInstance)
+		{
+			const FName ActorLabel = ActorDescInstance->GetActorLabel();
+			if (CachedInitParams.LoadRegionActors.Contains(ActorLabel))
+			{
+				Regions.Add(ActorDescInstance->GetEditorBounds());
+				FoundActors.Add(ActorLabel);
+			}
+			return true;
+		});
+
+		for (const FName ActorLabel: CachedInitParams.LoadRegionActors)
+		{
+			if (!FoundActors.Contains(ActorLabel))
+			{
+				UE_LOG(LogCommonAutomation, Error, TEXT("%s: Load region actor %s not found in world %s"), *FString(__FUNCTION__), *ActorLabel.ToString(), *World->GetName());
+			}
+		}
+	}
+
+	if (CachedInitParams.HasActorFilter())
+	{
+		// select actors by their descriptors, so that packages of filtered actors are never loaded
+		TArray<FGuid> ActorGuids;
+		FWorldPartitionHelpers::ForEachActorDescInstance(WorldPartition, AActor::StaticClass(), [this, &Regions, &ActorGuids](const FWorldPartitionActorDescInstance* ActorDescInstance)
+		{
+			const FBox Bounds = ActorDescInstance->GetEditorBounds();
+			const UClass* NativeClass = ActorDescInstance->GetActorNativeClass();
+			if (Regions.ContainsByPredicate([&Bounds](const FBox& Region) { return Region.Intersect(Bounds); }) &&
+				(NativeClass == nullptr || CachedInitParams.ShouldLoadActorClass(NativeClass)))
+			{
+				ActorGuids.Add(ActorDescInstance->GetGuid());
+			}
+			return true;
+		});
+
+		// loader adapter is owned by world partition and released together with it
+		UWorldPartitionEditorLoaderAdapter* LoaderAdapter = WorldPartition->CreateEditorLoaderAdapter<FLoaderAdapterActorList>(World);
+		static_cast<FLoaderAdapterActorList*>(LoaderAdapter->GetLoaderAdapter())->AddActors(ActorGuids);
+		LoaderAdapter->GetLoaderAdapter()->Load();
+		return;
+	}
+
+	for (const FBox& Region: Regions)
+	{
+		// loader adapter is owned by world partition and released together with it
+		UWorldPartitionEditorLoaderAdapter* LoaderAdapter = WorldPartition->CreateEditorLoaderAdapter<FLoaderAdapterShape>(World, Region, TEXT("Automation Load Region"));
+		LoaderAdapter->GetLoaderAdapter()->Load();
+	}
+#endif
+}
+
+void FAutomationWorld::FilterLevelActors(ULevel* Level)
+{
+	check(Level);
+	if (!CachedInitParams.HasActorFilter())
+	{
+		return;
+	}
+	
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorld_FilterLevelActors);
+	
+	// copy actors, as removed actors are nulled out in level's actor list
+	const TArray<AActor*> Actors{Level->Actors};
+	int32 NumRemoved = 0;
+	TArray<AActor*> AttachedActors;
+	for (AActor* Actor: Actors)
+	{
+		if (Actor == nullptr || CachedInitParams.ShouldLoadActor(Actor))
+		{
+			continue;
+		}
+
+		// kept children would otherwise stay attached to a removed parent
+		AttachedActors.Reset();
+		Actor->GetAttachedActors(AttachedActors, true, false);
+		for (AActor* AttachedActor: AttachedActors)
+		{
+			if (CachedInitParams.ShouldLoadActor(AttachedActor))
+			{
+				AttachedActor->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+			}
+		}
+
+		if (Actor->HasActorRegisteredAllComponents())
+		{
+			// editor world partition may register actors as they are loaded
+			Actor->UnregisterAllComponents();
+		}
+		World->RemoveActor(Actor, false);
+		Actor->MarkAsGarbage();
+		++NumRemoved;
+	}
+
+	NumFilteredActors += NumRemoved;
+	UE_LOG(LogCommonAutomation, Verbose, TEXT("%s: Filtered %d out of %d actors in %s"), *FString(__FUNCTION__), NumRemoved, Actors.Num(), *Level->GetPathName());
 }
 
 FWorldContext* FAutomationWorld::GetWorldContext() const
@@ -0,0 +1,160 @@
+#include "AutomationWorldFixture.h"
+
+#include "AutomationCommon.h"
+#include "EngineUtils.h"
+
+FAutomationWorldFixture::FAutomationWorldFixture(FAutomationTestBase& InOwningTest)
+	: OwningTest(InOwningTest)
+{
+	
+}
+
+FAutomationWorldFixture::~FAutomationWorldFixture()
+{
+	if (World.IsValid() && !UObjectInitialized())
+	{
+		// test pass was aborted and fixture of a static test instance outlived the engine, world objects are already gone and can't be destroyed
+		new FAutomationWorldPtr{MoveTemp(World)};
+	}
+	
+	Teardown();
+}
+
+void FAutomationWorldFixture::SetInitParams(const FAutomationWorldInitParams& InInitParams)
+{
+	if (World.IsValid())
+	{
+		Teardown();
+	}
+	
+	InitParams.Emplace(InInitParams);
+}
+
+void FAutomationWorldFixture::SetResetCallback(TFunction<void(FAutomationWorld&)>&& InResetCallback)
+{
+	ResetCallback = MoveTemp(InResetCallback);
+}
+
+FAutomationWorld& FAutomationWorldFixture::Setup()
+{
+	if (World.IsValid())
+	{
+		return *World;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorldFixture_Setup);
+	checkf(InitParams.IsSet(), TEXT("%s: init params are not set for world fixture"), *OwningTest.GetBeautifiedTestName());
+	
+	World = FAutomationWorld::CreateWorld(InitParams.GetValue());
+	check(World.IsValid());
+	World->FixtureTest = &OwningTest;
+
+	FixtureWorld = FObjectKey{World->GetWorld()};
+	FixtureActors.Reset();
+	for (TActorIterator<AActor> It{World->GetWorld()}; It; ++It)
+	{
+		FixtureActors.Add(FObjectKey{*It});
+	}
+
+	FAutomationTestFramework& Framework = FAutomationTestFramework::Get();
+	TestStartedHandle = Framework.OnTestStartEvent.AddRaw(this, &FAutomationWorldFixture::HandleTestStarted);
+	AllTestsEndedHandle = Framework.OnAfterAllTestsEvent.AddRaw(this, &FAutomationWorldFixture::HandleAllTestsEnded);
+	
+	return *World;
+}
+
+void FAutomationWorldFixture::ResetWorld()
+{
+	if (!World.IsValid())
+	{
+		return;
+	}
+	
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorldFixture_ResetWorld);
+	
+	UWorld* CurrentWorld = World->GetWorld();
+	if (FixtureWorld != FObjectKey{CurrentWorld})
+	{
+		// world travel happened during the test run, fixture world can't be restored
+		Teardown();
+		return;
+	}
+
+	TArray<AActor*, TInlineAllocator<64>> SpawnedActors;
+	for (TActorIterator<AActor> It{CurrentWorld}; It; ++It)
+	{
+		if (!FixtureActors.Contains(FObjectKey{*It}))
+		{
+			SpawnedActors.Add(*It);
+		}
+	}
+
+	for (AActor* Actor: SpawnedActors)
+	{
+		CurrentWorld->DestroyActor(Actor);
+	}
+
+	if (ResetCallback)
+	{
+		ResetCallback(*World);
+	}
+}
+
+void FAutomationWorldFixture::Teardown()
+{
+	if (TestStartedHandle.IsValid() || AllTestsEndedHandle.IsValid())
+	{
+		FAutomationTestFramework& Framework = FAutomationTestFramework::Get();
+		Framework.OnTestStartEvent.Remove(TestStartedHandle);
+		Framework.OnAfterAllTestsEvent.Remove(AllTestsEndedHandle);
+		TestStartedHandle.Reset();
+		AllTestsEndedHandle.Reset();
+	}
+
+	if (!World.IsValid())
+	{
+		return;
+	}
+	
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorldFixture_Teardown);
+	
+	World.Reset();
+	FixtureWorld = FObjectKey{};
+	FixtureActors.Reset();
+	
+	if (FAutomationWorld::Exists())
+	{
+		// fixture scope safety check: someone still holds a reference to fixture world
+		UE_LOG(LogCommonAutomation, Fatal, TEXT("Fixture automation world wasn't destroyed at the end of the test %s"), *OwningTest.GetBeautifiedTestName());
+	}
+}
+
+void FAutomationWorldFixture::HandleTestStarted(FAutomationTestBase* Test)
+{
+	if (Test != &OwningTest)
+	{
+		// another test started, fixture scope has ended
+		Teardown();
+	}
+}
+
+void FAutomationWorldFixture::HandleAllTestsEnded()
+{
+	Teardown();
+}
+
+void FAutomationWorldSpecBase::UseWorldFixture(const FAutomationWorldInitParams& InitParams, TFunction<void(FAutomationWorld&)> ResetCallback)
+{
+	WorldFixture.SetInitParams(InitParams);
+	WorldFixture.SetResetCallback(MoveTemp(ResetCallback));
+	
+	BeforeEach([this]
+	{
+		WorldFixture.Setup();
+	});
+
+	AfterEach([this]
+	{
+		WorldFixture.ResetWorld();
+	});
+}
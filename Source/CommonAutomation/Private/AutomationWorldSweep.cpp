@@ -0,0 +1,188 @@
+#include "AutomationWorldSweep.h"
+
+#include "AutomationLoadManifest.h"
+#include "CommonAutomationModule.h"
+#include "CommonAutomationSettings.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/GarbageCollection.h"
+#include "UObject/Package.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UObject/UObjectHash.h"
+
+namespace UE::Automation
+{
+	static uint64 GetUsedMemoryMB()
+	{
+		return FPlatformMemory::GetStats().UsedPhysical / (1024 * 1024);
+	}
+
+	/**
+	 * request async loads of @WorldPackage dependencies that are not loaded yet, requested packages are added to @OutPackages.
+	 * Loaded assets are added to @OutAssets to survive garbage collection until the world is loaded
+	 */
+	static TArray<int32> PrefetchWorld(FName WorldPackage, TArray<FName>& OutPackages, TArray<TStrongObjectPtr<UObject>>& OutAssets)
+	{
+		TRACE_CPUPROFILER_EVENT_SCOPE(SweepWorlds_Prefetch);
+
+		TArray<FName> Dependencies;
+		IAssetRegistry::GetChecked().GetDependencies(WorldPackage, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+
+		const FLoadPackageAsyncDelegate OnLoaded = FLoadPackageAsyncDelegate::CreateLambda([&OutAssets](const FName& PackageName, UPackage* Package, EAsyncLoadingResult::Type Result)
+		{
+			if (Package != nullptr)
+			{
+				ForEachObjectWithPackage(Package, [&OutAssets](UObject* Object)
+				{
+					if (Object->IsAsset())
+					{
+						OutAssets.Emplace(Object);
+					}
+					return true;
+				}, false);
+			}
+		});
+
+		TArray<int32> Requests;
+		for (const FName Dependency: Dependencies)
+		{
+			if (FLoadManifest::CanPreload(Dependency) && FindObjectFast<UPackage>(nullptr, Dependency) == nullptr)
+			{
+				Requests.Add(LoadPackageAsync(Dependency.ToString(), OnLoaded));
+				OutPackages.Add(Dependency);
+			}
+		}
+
+		return Requests;
+	}
+}
+
+TArray<FName> UE::Automation::FindSweepWorlds(FARFilter Filter)
+{
+	Filter.ClassPaths = {UWorld::StaticClass()->GetClassPathName()};
+	Filter.bRecursiveClasses = false;
+	if (Filter.PackagePaths.IsEmpty())
+	{
+		for (const FDirectoryPath& Path: UCommonAutomationSettings::Get()->GetAssetPaths())
+		{
+			Filter.PackagePaths.Add(FName{Path.Path});
+		}
+	}
+	Filter.bRecursivePaths = true;
+
+	TArray<FAssetData> Assets;
+	IAssetRegistry::GetChecked().GetAssets(Filter, Assets);
+
+	TArray<FName> Worlds;
+	Worlds.Reserve(Assets.Num());
+	for (const FAssetData& Asset: Assets)
+	{
+		Worlds.AddUnique(Asset.PackageName);
+	}
+	Worlds.Sort(FNameLexicalLess{});
+
+	return Worlds;
+}
+
+TArray<UE::Automation::FWorldSweepEntry> UE::Automation::SweepWorlds(const FARFilter& Filter, TFunctionRef<void(FAutomationWorld&)> Callback, const FWorldSweepOptions& Options)
+{
+	FAutomationTestBase* Test = FAutomationTestFramework::Get().GetCurrentTest();
+	check(Test != nullptr && !FAutomationWorld::Exists());
+	TRACE_CPUPROFILER_EVENT_SCOPE(SweepWorlds);
+
+	const TArray<FName> Worlds = FindSweepWorlds(Filter);
+	// stubbed worlds don't load their heavy dependencies, prefetching them would defeat the purpose
+	const bool bPrefetch = Options.bPrefetch && !(Options.InitParams.InitFlags & EWorldInitFlags::StubAssets);
+
+	TArray<FWorldSweepEntry> Entries;
+	Entries.Reserve(Worlds.Num());
+
+	TArray<int32> PrefetchRequests;
+	TArray<FName> PrefetchedPackages;
+	TArray<TStrongObjectPtr<UObject>> PrefetchedAssets;
+	// automation worlds are ticked outside of the engine loop, which is what normally processes async loading
+	auto ProcessPrefetch = [&PrefetchRequests, &Options]
+	{
+		if (!PrefetchRequests.IsEmpty())
+		{
+			TRACE_CPUPROFILER_EVENT_SCOPE(SweepWorlds_ProcessPrefetch);
+			ProcessAsyncLoading(true, false, Options.PrefetchBudgetMs / 1000.0);
+		}
+	};
+	uint64 LargestWorldMB = 0;
+
+	for (int32 Index = 0; Index < Worlds.Num(); ++Index)
+	{
+		FWorldSweepEntry& Entry = Entries.AddDefaulted_GetRef();
+		Entry.WorldPackage = Worlds[Index];
+		Entry.PrefetchedPackages = MoveTemp(PrefetchedPackages);
+
+		const uint64 MemoryBeforeMB = GetUsedMemoryMB();
+		uint64 StartCycles = FPlatformTime::Cycles64();
+
+		if (!PrefetchRequests.IsEmpty())
+		{
+			// world load would wait for the same packages anyway
+			FlushAsyncLoading(PrefetchRequests);
+			PrefetchRequests.Reset();
+		}
+		
+		FAutomationWorldPtr AutomationWorld = FAutomationWorldInitParams{Options.InitParams}.SetWorldPackage(Entry.WorldPackage.ToString()).Create();
+		// world holds its dependencies now
+		PrefetchedAssets.Reset();
+
+		Entry.LoadTimeMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+		Entry.UsedMemoryMB = GetUsedMemoryMB();
+		LargestWorldMB = FMath::Max(LargestWorldMB, Entry.UsedMemoryMB - FMath::Min(MemoryBeforeMB, Entry.UsedMemoryMB));
+
+		if (bPrefetch && Worlds.IsValidIndex(Index + 1))
+		{
+			// requests progress while callback runs, or get flushed when the next world is loaded
+			PrefetchedPackages.Reset();
+			PrefetchRequests = PrefetchWorld(Worlds[Index + 1], PrefetchedPackages, PrefetchedAssets);
+		}
+
+		if (AutomationWorld.IsValid())
+		{
+			Entry.bLoaded = true;
+			StartCycles = FPlatformTime::Cycles64();
+
+			UWorld* World = AutomationWorld->GetWorld();
+			const FDelegateHandle TickHandle = FWorldDelegates::OnWorldTickStart.AddLambda([World, &ProcessPrefetch](UWorld* TickedWorld, ELevelTick, float)
+			{
+				if (TickedWorld == World)
+				{
+					ProcessPrefetch();
+				}
+			});
+
+			ProcessPrefetch();
+			Callback(*AutomationWorld);
+			ProcessPrefetch();
+			
+			FWorldDelegates::OnWorldTickStart.Remove(TickHandle);
+			Entry.CallbackTimeMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+		}
+
+		StartCycles = FPlatformTime::Cycles64();
+		AutomationWorld.Reset();
+
+		if (Options.MemoryCapMB == 0 || GetUsedMemoryMB() + LargestWorldMB > Options.MemoryCapMB)
+		{
+			// prefetched assets of the next world are kept alive by strong pointers
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+			Entry.bCollectedGarbage = true;
+		}
+		Entry.ReleaseTimeMs = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+
+		if (Options.bReportTimings)
+		{
+			Test->AddInfo(FString::Printf(TEXT("%s: load %.2fms, callback %.2fms, release %.2fms%s, memory %lluMB"),
+				*Entry.WorldPackage.ToString(), Entry.LoadTimeMs, Entry.CallbackTimeMs, Entry.ReleaseTimeMs, Entry.bCollectedGarbage ? TEXT(" (GC)") : TEXT(""), Entry.UsedMemoryMB));
+		}
+	}
+
+	UE_LOG(LogCommonAutomation, Log, TEXT("%s: Swept %d worlds"), *FString(__FUNCTION__), Entries.Num());
+	return Entries;
+}
@@ -0,0 +1,225 @@
+#include "AutomationWorldTask.h"
+
+#include "AutomationWorld.h"
+#include "Engine/StreamableManager.h"
+
+UE::Automation::FWorldTask::FWorldTask(FWorldTask&& Other)
+	: Handle(Other.Handle)
+{
+	Other.Handle = nullptr;
+}
+
+UE::Automation::FWorldTask& UE::Automation::FWorldTask::operator=(FWorldTask&& Other)
+{
+	if (this != &Other)
+	{
+		Release();
+		Handle = Other.Handle;
+		Other.Handle = nullptr;
+	}
+
+	return *this;
+}
+
+UE::Automation::FWorldTask::~FWorldTask()
+{
+	Release();
+}
+
+void UE::Automation::FWorldTask::Release()
+{
+	if (!Handle)
+	{
+		return;
+	}
+
+	if (FWorldTaskScheduler* Scheduler = Handle.promise().Scheduler)
+	{
+		// task is destroyed while suspended, scheduler should not resume it
+		Scheduler->Cancel(Handle);
+	}
+
+	Handle.destroy();
+	Handle = nullptr;
+}
+
+bool UE::Automation::FWorldTaskAwaiter::await_ready() const
+{
+	switch (Condition.Type)
+	{
+	case FWorldTaskWaitCondition::EType::Frames:
+	case FWorldTaskWaitCondition::EType::Seconds:
+		return Condition.Amount <= 0.0;
+	case FWorldTaskWaitCondition::EType::Predicate:
+		return Condition.Predicate();
+	}
+
+	return true;
+}
+
+void UE::Automation::FWorldTaskAwaiter::await_suspend(std::coroutine_handle<FWorldTask::promise_type> Handle)
+{
+	Scheduler.Suspend(Handle, MoveTemp(Condition));
+}
+
+UE::Automation::FWorldTaskScheduler::~FWorldTaskScheduler()
+{
+	// detach suspended tasks, they will never be resumed
+	for (const TScheduledWait<uint64>& Wait: FrameWaits)
+	{
+		Wait.Handle.promise().Scheduler = nullptr;
+	}
+	for (const TScheduledWait<double>& Wait: TimeWaits)
+	{
+		Wait.Handle.promise().Scheduler = nullptr;
+	}
+	for (const FPredicateWait& Wait: PredicateWaits)
+	{
+		Wait.Handle.promise().Scheduler = nullptr;
+	}
+}
+
+void UE::Automation::FWorldTaskScheduler::Suspend(std::coroutine_handle<FWorldTask::promise_type> Handle, FWorldTaskWaitCondition&& Condition)
+{
+	check(Handle.promise().Scheduler == nullptr);
+	Handle.promise().Scheduler = this;
+	
+	switch (Condition.Type)
+	{
+	case FWorldTaskWaitCondition::EType::Frames:
+		FrameWaits.HeapPush({FrameIndex + static_cast<uint64>(Condition.Amount), Handle});
+		break;
+	case FWorldTaskWaitCondition::EType::Seconds:
+		TimeWaits.HeapPush({WorldTime + Condition.Amount, Handle});
+		break;
+	case FWorldTaskWaitCondition::EType::Predicate:
+		PredicateWaits.Add({MoveTemp(Condition.Predicate), Handle});
+		break;
+	}
+}
+
+void UE::Automation::FWorldTaskScheduler::Cancel(std::coroutine_handle<FWorldTask::promise_type> Handle)
+{
+	auto ByHandle = [Handle](const auto& Wait) { return Wait.Handle == Handle; };
+
+	if (const int32 Index = FrameWaits.IndexOfByPredicate(ByHandle); Index != INDEX_NONE)
+	{
+		FrameWaits.HeapRemoveAt(Index);
+	}
+	if (const int32 Index = TimeWaits.IndexOfByPredicate(ByHandle); Index != INDEX_NONE)
+	{
+		TimeWaits.HeapRemoveAt(Index);
+	}
+	PredicateWaits.RemoveAll(ByHandle);
+	// task may be already popped from wait lists and waiting to be resumed in ProcessFrame
+	ReadyTasks.Remove(Handle.address());
+	
+	Handle.promise().Scheduler = nullptr;
+}
+
+void UE::Automation::FWorldTaskScheduler::ProcessFrame(uint64 InFrameIndex, double InWorldTime)
+{
+	FrameIndex = InFrameIndex;
+	WorldTime = InWorldTime;
+
+	if (!HasPendingTasks())
+	{
+		return;
+	}
+	
+	TRACE_CPUPROFILER_EVENT_SCOPE(FWorldTaskScheduler_ProcessFrame);
+
+	// gather ready tasks first, resumed tasks are allowed to suspend again during this frame
+	TArray<std::coroutine_handle<FWorldTask::promise_type>, TInlineAllocator<16>> ReadyHandles;
+	while (!FrameWaits.IsEmpty() && FrameWaits.HeapTop().WakeUp <= FrameIndex)
+	{
+		TScheduledWait<uint64> Wait;
+		FrameWaits.HeapPop(Wait);
+		ReadyHandles.Add(Wait.Handle);
+	}
+	
+	while (!TimeWaits.IsEmpty() && TimeWaits.HeapTop().WakeUp <= WorldTime + UE_KINDA_SMALL_NUMBER)
+	{
+		TScheduledWait<double> Wait;
+		TimeWaits.HeapPop(Wait);
+		ReadyHandles.Add(Wait.Handle);
+	}
+
+	for (auto It = PredicateWaits.CreateIterator(); It; ++It)
+	{
+		if (It->Predicate())
+		{
+			ReadyHandles.Add(It->Handle);
+			It.RemoveCurrent();
+		}
+	}
+
+	for (std::coroutine_handle<FWorldTask::promise_type> Handle: ReadyHandles)
+	{
+		ReadyTasks.Add(Handle.address());
+	}
+
+	for (std::coroutine_handle<FWorldTask::promise_type> Handle: ReadyHandles)
+	{
+		// ready task may have been destroyed by a task resumed before it, its coroutine frame is freed
+		if (ReadyTasks.Remove(Handle.address()) > 0)
+		{
+			Resume(Handle);
+		}
+	}
+}
+
+void UE::Automation::FWorldTaskScheduler::Resume(std::coroutine_handle<FWorldTask::promise_type> Handle)
+{
+	Handle.promise().Scheduler = nullptr;
+	Handle.resume();
+}
+
+UE::Automation::FWorldTaskAwaiter FAutomationWorld::Frames(int32 NumFrames)
+{
+	return {GetTaskScheduler(), {UE::Automation::FWorldTaskWaitCondition::EType::Frames, static_cast<double>(NumFrames), {}}};
+}
+
+UE::Automation::FWorldTaskAwaiter FAutomationWorld::Seconds(double NumSeconds)
+{
+	return {GetTaskScheduler(), {UE::Automation::FWorldTaskWaitCondition::EType::Seconds, NumSeconds, {}}};
+}
+
+UE::Automation::FWorldTaskAwaiter FAutomationWorld::Until(TFunction<bool()> Predicate)
+{
+	check(Predicate);
+	return {GetTaskScheduler(), {UE::Automation::FWorldTaskWaitCondition::EType::Predicate, 0.0, MoveTemp(Predicate)}};
+}
+
+UE::Automation::FWorldTaskAwaiter FAutomationWorld::Loaded(TSharedPtr<FStreamableHandle> Handle)
+{
+	return Until([Handle = MoveTemp(Handle)]
+	{
+		return !Handle.IsValid() || Handle->HasLoadCompleted() || Handle->WasCanceled();
+	});
+}
+
+bool FAutomationWorld::RunTasks(int32 MaxFrames)
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FAutomationWorld_RunTasks);
+	
+	while (TaskScheduler.IsValid() && TaskScheduler->HasPendingTasks() && MaxFrames > 0)
+	{
+		TickWorld(1);
+		--MaxFrames;
+	}
+
+	return !TaskScheduler.IsValid() || !TaskScheduler->HasPendingTasks();
+}
+
+UE::Automation::FWorldTaskScheduler& FAutomationWorld::GetTaskScheduler()
+{
+	if (!TaskScheduler.IsValid())
+	{
+		TaskScheduler = MakeUnique<UE::Automation::FWorldTaskScheduler>();
+		// sync scheduler with frames that have already been ticked
+		TaskScheduler->ProcessFrame(TickedFrames, TickedTime);
+	}
+
+	return *TaskScheduler;
+}
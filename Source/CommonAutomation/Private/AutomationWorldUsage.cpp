@@ -0,0 +1,268 @@
+#include "AutomationWorldUsage.h"
+
+#include "CommonAutomationSettings.h"
+#include "EngineUtils.h"
+#include "NavigationData.h"
+#include "Components/AudioComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "NavMesh/NavMeshBoundsVolume.h"
+#include "Particles/ParticleSystemComponent.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+
+namespace UE::Automation
+{
+	/** flags that are derived from world usage, other flags are kept as requested */
+	static constexpr EWorldInitFlags UsageFlags = EWorldInitFlags::InitScene | EWorldInitFlags::InitAudio | EWorldInitFlags::InitPhysics |
+		EWorldInitFlags::InitNavigation | EWorldInitFlags::InitAI | EWorldInitFlags::InitWeldedBodies | EWorldInitFlags::InitCollision |
+		EWorldInitFlags::InitFX | EWorldInitFlags::CreateGameInstance | EWorldInitFlags::CreateLocalPlayer;
+}
+
+UE::Automation::FWorldUsageProbe::FWorldUsageProbe(const FAutomationWorldInitParams& InitParams)
+	: RequestedFlags(InitParams.InitFlags)
+	, RequestedWorldType(InitParams.WorldType)
+	, RequestedGameMode(InitParams.DefaultGameMode)
+{
+	// enabled subsystems are not used until they are accessed
+	RequestedSubsystems.Append(InitParams.WorldSubsystems);
+	RequestedSubsystems.Append(InitParams.GameSubsystems);
+	RequestedSubsystems.Append(InitParams.PlayerSubsystems);
+}
+
+void UE::Automation::FWorldUsageProbe::NotifySubsystemAccessed(const UClass* SubsystemClass)
+{
+	if (SubsystemClass == nullptr)
+	{
+		return;
+	}
+	
+	AccessedSubsystems.Add(SubsystemClass);
+	if (SubsystemClass->IsChildOf<ULocalPlayerSubsystem>())
+	{
+		Usage |= EWorldUsage::GameInstance | EWorldUsage::LocalPlayer;
+	}
+	else if (SubsystemClass->IsChildOf<UGameInstanceSubsystem>())
+	{
+		Usage |= EWorldUsage::GameInstance;
+	}
+}
+
+void UE::Automation::FWorldUsageProbe::Sample(UWorld* World)
+{
+	check(World);
+	TRACE_CPUPROFILER_EVENT_SCOPE(FWorldUsageProbe_Sample);
+
+	for (TActorIterator<AActor> It{World}; It; ++It)
+	{
+		AActor* Actor = *It;
+		if (Actor->IsA<ANavigationData>() || Actor->IsA<ANavMeshBoundsVolume>())
+		{
+			Usage |= EWorldUsage::Navigation;
+		}
+
+		if (const APawn* Pawn = Cast<APawn>(Actor))
+		{
+			if (const AController* Controller = Pawn->GetController())
+			{
+				Usage |= Controller->IsPlayerController() ? EWorldUsage::None : EWorldUsage::AI;
+				if (const APlayerController* PlayerController = Cast<APlayerController>(Controller); PlayerController && PlayerController->IsLocalPlayerController())
+				{
+					Usage |= EWorldUsage::LocalPlayer | EWorldUsage::GameInstance;
+				}
+			}
+		}
+
+		Actor->ForEachComponent(false, [this](UActorComponent* Component)
+		{
+			if (!Component->IsRegistered())
+			{
+				return;
+			}
+			
+			if (const UPrimitiveComponent* Primitive = Cast<UPrimitiveComponent>(Component))
+			{
+				if (Primitive->IsVisible())
+				{
+					Usage |= EWorldUsage::ScenePrimitives;
+				}
+				// check collision settings instead of physics state, which is not created without physics scene
+				if (Primitive->IsQueryCollisionEnabled() && Primitive->GetBodySetup() != nullptr)
+				{
+					Usage |= EWorldUsage::Collision;
+				}
+				if (Primitive->BodyInstance.bSimulatePhysics)
+				{
+					Usage |= EWorldUsage::PhysicsSimulation;
+				}
+			}
+
+			if (const UAudioComponent* Audio = Cast<UAudioComponent>(Component); Audio && Audio->Sound && (Audio->IsActive() || Audio->bAutoActivate))
+			{
+				Usage |= EWorldUsage::Audio;
+			}
+			
+			if (Component->IsA<UFXSystemComponent>() && Component->IsActive())
+			{
+				Usage |= EWorldUsage::FX;
+			}
+		});
+	}
+
+	if (const AGameModeBase* GameMode = World->GetAuthGameMode())
+	{
+		const UCommonAutomationSettings* Settings = UCommonAutomationSettings::Get();
+		const UClass* DefaultGameMode = RequestedGameMode ? RequestedGameMode.Get() : Settings->DefaultGameMode.Get();
+		if (DefaultGameMode != nullptr && GameMode->GetClass() != DefaultGameMode)
+		{
+			// game mode set by world settings
+			Usage |= EWorldUsage::GameInstance;
+		}
+		else if (RequestedGameMode != nullptr)
+		{
+			// game mode explicitly requested by test
+			Usage |= EWorldUsage::GameInstance;
+		}
+	}
+}
+
+EWorldInitFlags UE::Automation::FWorldUsageProbe::GetRecommendedFlags() const
+{
+	return RecommendFlags(Usage, RequestedFlags);
+}
+
+EWorldInitFlags UE::Automation::FWorldUsageProbe::GetUnusedFlags() const
+{
+	return RequestedFlags & ~GetRecommendedFlags();
+}
+
+TArray<UClass*> UE::Automation::FWorldUsageProbe::GetUnusedSubsystems() const
+{
+	TArray<UClass*> Unused;
+	for (UClass* SubsystemClass: RequestedSubsystems)
+	{
+		if (!AccessedSubsystems.Contains(SubsystemClass))
+		{
+			Unused.Add(SubsystemClass);
+		}
+	}
+
+	return Unused;
+}
+
+FString UE::Automation::FWorldUsageProbe::GetSuggestedInitParams() const
+{
+	TStringBuilder<256> Builder;
+	Builder.Appendf(TEXT("FAutomationWorldInitParams{EWorldType::%s, %s}"), RequestedWorldType == EWorldType::Editor ? TEXT("Editor") : TEXT("Game"), *FlagsToCode(GetRecommendedFlags()));
+	for (const UClass* SubsystemClass: RequestedSubsystems)
+	{
+		if (AccessedSubsystems.Contains(SubsystemClass))
+		{
+			Builder.Appendf(TEXT(".EnableSubsystem<%s%s>()"), SubsystemClass->GetPrefixCPP(), *SubsystemClass->GetName());
+		}
+	}
+
+	return Builder.ToString();
+}
+
+EWorldInitFlags UE::Automation::FWorldUsageProbe::RecommendFlags(EWorldUsage InUsage, EWorldInitFlags InRequestedFlags)
+{
+	EWorldInitFlags Flags = InRequestedFlags & ~UsageFlags;
+	if (EnumHasAnyFlags(InUsage, EWorldUsage::ScenePrimitives))
+	{
+		Flags |= EWorldInitFlags::InitScene;
+	}
+	if (EnumHasAnyFlags(InUsage, EWorldUsage::Collision))
+	{
+		Flags |= EWorldInitFlags::InitPhysics | EWorldInitFlags::InitCollision;
+	}
+	if (EnumHasAnyFlags(InUsage, EWorldUsage::PhysicsSimulation))
+	{
+		Flags |= EWorldInitFlags::InitPhysics | EWorldInitFlags::InitWeldedBodies;
+	}
+	if (EnumHasAnyFlags(InUsage, EWorldUsage::Navigation))
+	{
+		Flags |= EWorldInitFlags::InitNavigation;
+	}
+	if (EnumHasAnyFlags(InUsage, EWorldUsage::AI))
+	{
+		Flags |= EWorldInitFlags::InitAI;
+	}
+	if (EnumHasAnyFlags(InUsage, EWorldUsage::Audio))
+	{
+		Flags |= EWorldInitFlags::InitAudio;
+	}
+	if (EnumHasAnyFlags(InUsage, EWorldUsage::FX))
+	{
+		Flags |= EWorldInitFlags::InitFX;
+	}
+	if (EnumHasAnyFlags(InUsage, EWorldUsage::GameInstance))
+	{
+		Flags |= EWorldInitFlags::CreateGameInstance;
+	}
+	if (EnumHasAnyFlags(InUsage, EWorldUsage::LocalPlayer))
+	{
+		Flags |= EWorldInitFlags::CreateGameInstance | EWorldInitFlags::CreateLocalPlayer;
+	}
+	
+	return Flags;
+}
+
+TArray<const TCHAR*> UE::Automation::FWorldUsageProbe::GetFlagNames(EWorldInitFlags Flags)
+{
+	static const TPair<EWorldInitFlags, const TCHAR*> FlagNames[] = {
+		{EWorldInitFlags::InitScene,			TEXT("InitScene")},
+		{EWorldInitFlags::InitAudio,			TEXT("InitAudio")},
+		{EWorldInitFlags::InitHitProxy,			TEXT("InitHitProxy")},
+		{EWorldInitFlags::InitPhysics,			TEXT("InitPhysics")},
+		{EWorldInitFlags::InitNavigation,		TEXT("InitNavigation")},
+		{EWorldInitFlags::InitAI,				TEXT("InitAI")},
+		{EWorldInitFlags::InitWeldedBodies,		TEXT("InitWeldedBodies")},
+		{EWorldInitFlags::InitCollision,		TEXT("InitCollision")},
+		{EWorldInitFlags::InitFX,				TEXT("InitFX")},
+		{EWorldInitFlags::InitWorldPartition,	TEXT("InitWorldPartition")},
+		{EWorldInitFlags::DisableStreaming,		TEXT("DisableStreaming")},
+		{EWorldInitFlags::CreateGameInstance,	TEXT("CreateGameInstance")},
+		{EWorldInitFlags::CreateLocalPlayer,	TEXT("CreateLocalPlayer")},
+		{EWorldInitFlags::StartPlay,			TEXT("StartPlay")},
+		{EWorldInitFlags::LazyScene,			TEXT("LazyScene")},
+		{EWorldInitFlags::StubAssets,			TEXT("StubAssets")},
+		{EWorldInitFlags::PreloadExternalActorDependencies, TEXT("PreloadExternalActorDependencies")},
+	};
+
+	TArray<const TCHAR*> Names;
+	for (const TPair<EWorldInitFlags, const TCHAR*>& Pair: FlagNames)
+	{
+		if (EnumHasAnyFlags(Flags, Pair.Key))
+		{
+			Names.Add(Pair.Value);
+		}
+	}
+	
+	return Names;
+}
+
+FString UE::Automation::FWorldUsageProbe::FlagsToString(EWorldInitFlags Flags)
+{
+	const TArray<const TCHAR*> Names = GetFlagNames(Flags);
+	return Names.IsEmpty() ? TEXT("None") : FString::Join(Names, TEXT(" | "));
+}
+
+FString UE::Automation::FWorldUsageProbe::FlagsToCode(EWorldInitFlags Flags)
+{
+	const TArray<const TCHAR*> Names = GetFlagNames(Flags);
+	if (Names.IsEmpty())
+	{
+		return TEXT("EWorldInitFlags::None");
+	}
+
+	TStringBuilder<256> Builder;
+	for (const TCHAR* Name: Names)
+	{
+		Builder << (Builder.Len() > 0 ? TEXT(" | EWorldInitFlags::") : TEXT("EWorldInitFlags::")) << Name;
+	}
+	
+	return Builder.ToString();
+}
@@ -0,0 +1,392 @@
+#include "CommonAutomationForkServerCommandlet.h"
+
+#include "CommonAutomationModule.h"
+#include "CommonAutomationSettings.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Containers/Ticker.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Fork.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "Subsystems/WorldSubsystem.h"
+
+#if PLATFORM_LINUX
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#if PLATFORM_LINUX
+namespace UE::Automation::Private
+{
+	/** worker process and its share of tests */
+	struct FForkWorker: UCommonAutomationForkServerCommandlet::FWorkerTests
+	{
+		pid_t Pid = -1;
+		int32 ReadFd = -1;
+	};
+	
+	static void WriteLine(int32 Fd, const FString& Line)
+	{
+		const FTCHARToUTF8 Converted{*(Line + TEXT("\n"))};
+		const ANSICHAR* Data = Converted.Get();
+		int32 Remaining = Converted.Length();
+		while (Remaining > 0)
+		{
+			const ssize_t Written = write(Fd, Data, Remaining);
+			if (Written <= 0)
+			{
+				return;
+			}
+			Data += Written;
+			Remaining -= Written;
+		}
+	}
+
+	static bool RunAutomationTest(const FString& TestName, int32& OutNumErrors)
+	{
+		FAutomationTestFramework& Framework = FAutomationTestFramework::Get();
+		Framework.StartTestByName(TestName, 0);
+		while (!Framework.ExecuteLatentCommands())
+		{
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+			FTSTicker::GetCoreTicker().Tick(FApp::GetDeltaTime());
+		}
+
+		FAutomationTestExecutionInfo ExecutionInfo;
+		const bool bSuccess = Framework.StopTest(ExecutionInfo);
+		OutNumErrors = ExecutionInfo.GetErrorTotal();
+		
+		return bSuccess;
+	}
+
+	/** worker process entry point, never returns */
+	static void RunWorker(TConstArrayView<FString> Tests, int32 WriteFd)
+	{
+		FAutomationTestFramework& Framework = FAutomationTestFramework::Get();
+		Framework.OnBeforeAllTestsEvent.Broadcast();
+		
+		for (const FString& TestName: Tests)
+		{
+			WriteLine(WriteFd, FString::Printf(TEXT("S\t%s"), *TestName));
+			
+			int32 NumErrors = 0;
+			const bool bSuccess = RunAutomationTest(TestName, NumErrors);
+			WriteLine(WriteFd, FString::Printf(TEXT("R\t%d\t%d\t%s"), bSuccess ? 1 : 0, NumErrors, *TestName));
+		}
+		
+		Framework.OnAfterAllTestsEvent.Broadcast();
+		
+		GLog->Flush();
+		close(WriteFd);
+		// skip engine shutdown, parent process owns shared state
+		_exit(0);
+	}
+
+	static bool SpawnWorker(FForkWorker& Worker, uint16 ChildIndex)
+	{
+		int32 Pipe[2];
+		if (pipe(Pipe) != 0)
+		{
+			return false;
+		}
+
+		// flush buffered output so that it isn't duplicated by the child
+		GLog->Flush();
+		
+		const pid_t Pid = fork();
+		if (Pid < 0)
+		{
+			close(Pipe[0]);
+			close(Pipe[1]);
+			return false;
+		}
+
+		if (Pid == 0)
+		{
+			close(Pipe[0]);
+			FForkProcessHelper::SetIsForkedChildProcess(ChildIndex);
+			FForkProcessHelper::OnForkingOccured();
+			FCoreDelegates::OnPostFork.Broadcast(EForkProcessRole::Child);
+			
+			RunWorker(Worker.Tests, Pipe[1]);
+		}
+
+		close(Pipe[1]);
+		fcntl(Pipe[0], F_SETFL, fcntl(Pipe[0], F_GETFL) | O_NONBLOCK);
+		
+		Worker.Pid = Pid;
+		Worker.ReadFd = Pipe[0];
+		Worker.NumStarted = 0;
+		Worker.NumCompleted = 0;
+		Worker.Buffer.Reset();
+		
+		return true;
+	}
+}
+#endif
+
+UCommonAutomationForkServerCommandlet::UCommonAutomationForkServerCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UCommonAutomationForkServerCommandlet::Main(const FString& Params)
+{
+#if PLATFORM_LINUX
+	using namespace UE::Automation::Private;
+	
+	FString Filter;
+	FParse::Value(*Params, TEXT("Filter="), Filter);
+	
+	int32 NumWorkers = FPlatformMisc::NumberOfCores();
+	FParse::Value(*Params, TEXT("Workers="), NumWorkers);
+	NumWorkers = FMath::Max(NumWorkers, 1);
+
+	int32 Shard = 0, NumShards = 1;
+	FParse::Value(*Params, TEXT("Shard="), Shard);
+	FParse::Value(*Params, TEXT("NumShards="), NumShards);
+
+	if (!FForkProcessHelper::IsForkRequested())
+	{
+		UE_LOG(LogCommonAutomation, Warning, TEXT("%s: -WaitAndFork is not specified, forked workers will not have engine worker threads"), *FString(__FUNCTION__));
+	}
+	
+	WarmUp();
+
+	const TArray<FTestEntry> Tests = GatherTests(Filter, Shard, FMath::Max(NumShards, 1));
+	UE_LOG(LogCommonAutomation, Display, TEXT("%s: running %d tests in %d workers"), *FString(__FUNCTION__), Tests.Num(), NumWorkers);
+
+	// distribute tests between workers, interleaved so that related tests are spread across workers
+	TArray<FForkWorker> Workers;
+	Workers.SetNum(FMath::Min(NumWorkers, Tests.Num()));
+	for (int32 Index = 0; Index < Tests.Num(); ++Index)
+	{
+		Workers[Index % Workers.Num()].Tests.Add(Tests[Index].TestName);
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	uint16 NumForks = 0;
+	int32 NumCrashes = 0;
+	int32 NumStartupFailures = 0;
+	TMap<FString, FTestResult> Results;
+	
+	for (FForkWorker& Worker: Workers)
+	{
+		if (!SpawnWorker(Worker, ++NumForks))
+		{
+			UE_LOG(LogCommonAutomation, Error, TEXT("%s: failed to fork worker process"), *FString(__FUNCTION__));
+			return 1;
+		}
+	}
+
+	while (Workers.ContainsByPredicate([](const FForkWorker& Worker) { return Worker.Pid > 0; }))
+	{
+		TArray<pollfd> PollFds;
+		TArray<int32> PollWorkers;
+		for (int32 Index = 0; Index < Workers.Num(); ++Index)
+		{
+			if (Workers[Index].Pid > 0)
+			{
+				PollFds.Add({Workers[Index].ReadFd, POLLIN, 0});
+				PollWorkers.Add(Index);
+			}
+		}
+
+		if (poll(PollFds.GetData(), PollFds.Num(), 1000) <= 0)
+		{
+			continue;
+		}
+
+		for (int32 PollIndex = 0; PollIndex < PollFds.Num(); ++PollIndex)
+		{
+			if (PollFds[PollIndex].revents == 0)
+			{
+				continue;
+			}
+			
+			FForkWorker& Worker = Workers[PollWorkers[PollIndex]];
+			
+			ANSICHAR ReadBuffer[4096];
+			ssize_t NumRead = 0;
+			while ((NumRead = read(Worker.ReadFd, ReadBuffer, sizeof(ReadBuffer))) > 0)
+			{
+				Worker.Buffer.Append(ReadBuffer, NumRead);
+			}
+			ProcessOutput(Worker, Results);
+
+			if (NumRead != 0)
+			{
+				// no more data yet, pipe is still open
+				continue;
+			}
+
+			// pipe closed, worker either finished or crashed
+			close(Worker.ReadFd);
+			int32 Status = 0;
+			waitpid(Worker.Pid, &Status, 0);
+			Worker.Pid = -1;
+
+			const bool bExitedCleanly = WIFEXITED(Status) && WEXITSTATUS(Status) == 0;
+			const EWorkerExit Exit = HandleWorkerExit(Worker, bExitedCleanly, Results);
+			if (Exit == EWorkerExit::Completed)
+			{
+				continue;
+			}
+
+			if (Exit == EWorkerExit::StartupFailed)
+			{
+				++NumStartupFailures;
+				UE_LOG(LogCommonAutomation, Error, TEXT("%s: worker failed to start, status %d"), *FString(__FUNCTION__), Status);
+				if (Worker.NumStartupFailures >= MaxStartupFailures)
+				{
+					UE_LOG(LogCommonAutomation, Error, TEXT("%s: giving up on %d tests after %d worker startup failures"), *FString(__FUNCTION__), Worker.Tests.Num(), Worker.NumStartupFailures);
+					Worker.Tests.Reset();
+				}
+			}
+			else
+			{
+				++NumCrashes;
+			}
+
+			if (!Worker.Tests.IsEmpty() && !SpawnWorker(Worker, ++NumForks))
+			{
+				UE_LOG(LogCommonAutomation, Error, TEXT("%s: failed to fork replacement worker process"), *FString(__FUNCTION__));
+			}
+		}
+	}
+
+	int32 NumFailed = 0;
+	for (const FTestEntry& Test: Tests)
+	{
+		const FTestResult* Result = Results.Find(Test.TestName);
+		if (Result == nullptr || !Result->bSuccess)
+		{
+			++NumFailed;
+			UE_LOG(LogCommonAutomation, Error, TEXT("Test failed: %s%s"), *Test.FullPath, Result == nullptr ? TEXT(" (not run)") : Result->bCrashed ? TEXT(" (crashed)") : TEXT(""));
+		}
+	}
+	
+	UE_LOG(LogCommonAutomation, Display, TEXT("%s: %d tests, %d failed, %d worker crashes, %d worker startup failures, %.2fs"),
+		*FString(__FUNCTION__), Tests.Num(), NumFailed, NumCrashes, NumStartupFailures, FPlatformTime::Seconds() - StartTime);
+	
+	return NumFailed > 0 ? 1 : 0;
+#else
+	UE_LOG(LogCommonAutomation, Error, TEXT("%s: fork server is supported only on Linux"), *FString(__FUNCTION__));
+	return 1;
+#endif
+}
+
+void UCommonAutomationForkServerCommandlet::ProcessOutput(FWorkerTests& Worker, TMap<FString, FTestResult>& Results)
+{
+	int32 LineStart = 0;
+	for (int32 Index = 0; Index < Worker.Buffer.Num(); ++Index)
+	{
+		if (Worker.Buffer[Index] != '\n')
+		{
+			continue;
+		}
+
+		const FString Line{FUTF8ToTCHAR{Worker.Buffer.GetData() + LineStart, Index - LineStart}};
+		LineStart = Index + 1;
+		
+		TArray<FString> Tokens;
+		Line.ParseIntoArray(Tokens, TEXT("\t"), false);
+		if (Tokens.Num() == 2 && Tokens[0] == TEXT("S"))
+		{
+			++Worker.NumStarted;
+			// worker got far enough to run a test
+			Worker.NumStartupFailures = 0;
+		}
+		else if (Tokens.Num() == 4 && Tokens[0] == TEXT("R"))
+		{
+			++Worker.NumCompleted;
+			FTestResult& Result = Results.FindOrAdd(Tokens[3]);
+			Result.bSuccess = Tokens[1] == TEXT("1");
+			Result.NumErrors = FCString::Atoi(*Tokens[2]);
+		}
+	}
+	
+	Worker.Buffer.RemoveAt(0, LineStart);
+}
+
+UCommonAutomationForkServerCommandlet::EWorkerExit UCommonAutomationForkServerCommandlet::HandleWorkerExit(FWorkerTests& Worker, bool bExitedCleanly, TMap<FString, FTestResult>& Results)
+{
+	if (bExitedCleanly && Worker.NumCompleted == Worker.Tests.Num())
+	{
+		Worker.Tests.Reset();
+		return EWorkerExit::Completed;
+	}
+
+	if (Worker.NumStarted == 0)
+	{
+		// worker never reached the first test, e.g. it failed during post fork initialization
+		++Worker.NumStartupFailures;
+		return EWorkerExit::StartupFailed;
+	}
+
+	if (Worker.NumStarted > Worker.NumCompleted && Worker.Tests.IsValidIndex(Worker.NumStarted - 1))
+	{
+		// test that was running when worker crashed is marked as failed
+		const FString& CrashedTest = Worker.Tests[Worker.NumStarted - 1];
+		UE_LOG(LogCommonAutomation, Error, TEXT("%s: worker crashed while running %s"), *FString(__FUNCTION__), *CrashedTest);
+		Results.FindOrAdd(CrashedTest).bCrashed = true;
+	}
+	else
+	{
+		// worker crashed between tests or during shutdown, finished tests keep their results
+		UE_LOG(LogCommonAutomation, Error, TEXT("%s: worker crashed after %d tests"), *FString(__FUNCTION__), Worker.NumCompleted);
+	}
+
+	// replacement worker continues with tests that weren't started
+	Worker.Tests.RemoveAt(0, FMath::Min(Worker.NumStarted, Worker.Tests.Num()));
+	return EWorkerExit::Crashed;
+}
+
+void UCommonAutomationForkServerCommandlet::WarmUp() const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UCommonAutomationForkServerCommandlet_WarmUp);
+
+	// complete asset registry scan, so that workers don't repeat it
+	IAssetRegistry::GetChecked().SearchAllAssets(true);
+	// initialize subsystem containers
+	const UCommonAutomationSettings* Settings = UCommonAutomationSettings::Get();
+	Settings->GetDisabledSubsystems<UWorldSubsystem>();
+	Settings->GetDisabledSubsystems<UGameInstanceSubsystem>();
+	Settings->GetDisabledSubsystems<ULocalPlayerSubsystem>();
+	// reduce memory shared between workers that would be copied on first GC in every worker
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+}
+
+TArray<UCommonAutomationForkServerCommandlet::FTestEntry> UCommonAutomationForkServerCommandlet::GatherTests(const FString& Filter, int32 Shard, int32 NumShards) const
+{
+	FAutomationTestFramework& Framework = FAutomationTestFramework::Get();
+	Framework.SetRequestedTestFilter(AUTOTEST_FILTER_MASK);
+	
+	TArray<FAutomationTestInfo> TestInfos;
+	Framework.GetValidTestNames(TestInfos);
+
+	TArray<FTestEntry> Tests;
+	for (const FAutomationTestInfo& TestInfo: TestInfos)
+	{
+		if (Filter.IsEmpty() || TestInfo.GetFullTestPath().StartsWith(Filter))
+		{
+			Tests.Add({TestInfo.GetFullTestPath(), TestInfo.GetTestName()});
+		}
+	}
+	Tests.Sort([](const FTestEntry& Lhs, const FTestEntry& Rhs) { return Lhs.FullPath < Rhs.FullPath; });
+
+	TArray<FTestEntry> ShardTests;
+	for (int32 Index = Shard; Index < Tests.Num(); Index += NumShards)
+	{
+		ShardTests.Add(Tests[Index]);
+	}
+
+	return ShardTests;
+}
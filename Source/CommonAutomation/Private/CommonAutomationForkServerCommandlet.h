@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "CommonAutomationForkServerCommandlet.generated.h"
+
+/**
+ * Runs automation tests in copy-on-write worker processes forked from a fully initialized editor. Linux only.
+ * Editor initializes once (modules, asset registry, automation settings), then forks workers that run a share of tests each
+ * and report results over a pipe. Crashed worker is replaced by a new fork that continues with the remaining tests.
+ * Worker that fails before starting any test is reported as a startup failure and replaced, its tests are not blamed.
+ *
+ * UnrealEditor-Cmd Project.uproject -run=CommonAutomationForkServer -Filter=Project.Tests -Workers=8 -nullrhi -WaitAndFork -PostForkThreading
+ * -Filter				run tests which full path starts with filter
+ * -Workers				number of worker processes, defaults to number of cores
+ * -Shard -NumShards	run only a shard of matching tests, to split tests between machines
+ * -WaitAndFork -PostForkThreading	defer engine worker threads until after fork, otherwise forked workers run single threaded
+ */
+UCLASS()
+class UCommonAutomationForkServerCommandlet: public UCommandlet
+{
+	GENERATED_BODY()
+public:
+
+	UCommonAutomationForkServerCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+	/** Tests assigned to a worker process and its progress reported over the pipe */
+	struct FWorkerTests
+	{
+		TArray<FString> Tests;
+		/** number of tests worker started, including the one currently running */
+		int32 NumStarted = 0;
+		/** number of tests worker reported results for */
+		int32 NumCompleted = 0;
+		/** number of consecutive worker processes that exited before starting a test */
+		int32 NumStartupFailures = 0;
+		/** received output that doesn't form a complete line yet */
+		TArray<ANSICHAR> Buffer;
+	};
+
+	/** Test result reported by worker */
+	struct FTestResult
+	{
+		bool bSuccess = false;
+		bool bCrashed = false;
+		int32 NumErrors = 0;
+	};
+
+	enum class EWorkerExit: uint8
+	{
+		Completed,		// every assigned test reported its result
+		StartupFailed,	// worker exited before starting any test, no test is blamed
+		Crashed			// worker exited while running a test or between tests
+	};
+
+	/** parse complete lines received from @Worker */
+	static void ProcessOutput(FWorkerTests& Worker, TMap<FString, FTestResult>& Results);
+	/**
+	 * update @Worker after its process exited. Test that was running is marked as crashed, tests that already finished are removed
+	 * @return how the worker exited, worker should be replaced if it still has tests
+	 */
+	static EWorkerExit HandleWorkerExit(FWorkerTests& Worker, bool bExitedCleanly, TMap<FString, FTestResult>& Results);
+
+	/** number of times a worker that fails before starting a test is replaced before its tests are given up */
+	static constexpr int32 MaxStartupFailures = 2;
+
+protected:
+
+	struct FTestEntry
+	{
+		/** full test path, used for filtering and reporting */
+		FString FullPath;
+		/** test name with parameters, used to start the test */
+		FString TestName;
+	};
+	
+	/** initialize everything shared by worker processes before the first fork */
+	void WarmUp() const;
+	/** @return tests which full path starts with @Filter, sorted and sharded */
+	TArray<FTestEntry> GatherTests(const FString& Filter, int32 Shard, int32 NumShards) const;
+};
@@ -0,0 +1,104 @@
+#include "CommonAutomationSelectTestsCommandlet.h"
+
+#include "AutomationTestDependencies.h"
+#include "CommonAutomationModule.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+
+UCommonAutomationSelectTestsCommandlet::UCommonAutomationSelectTestsCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UCommonAutomationSelectTestsCommandlet::Main(const FString& Params)
+{
+	using namespace UE::Automation;
+	
+	FString Filter, Output;
+	FParse::Value(*Params, TEXT("Filter="), Filter);
+	FParse::Value(*Params, TEXT("Output="), Output);
+
+	double MaxAgeDays = 7.0;
+	FParse::Value(*Params, TEXT("MaxAgeDays="), MaxAgeDays);
+
+	TArray<FString> ChangedFiles;
+	FString Changed;
+	if (FParse::Value(*Params, TEXT("Changed="), Changed, false))
+	{
+		Changed.ParseIntoArray(ChangedFiles, TEXT(","));
+	}
+
+	FString ChangedFile;
+	if (FParse::Value(*Params, TEXT("ChangedFile="), ChangedFile))
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *ChangedFile))
+		{
+			UE_LOG(LogCommonAutomation, Error, TEXT("%s: failed to read %s"), *FString(__FUNCTION__), *ChangedFile);
+			return 1;
+		}
+		ChangedFiles.Append(Lines);
+	}
+
+	for (FString& File: ChangedFiles)
+	{
+		File.TrimStartAndEndInline();
+	}
+	ChangedFiles.RemoveAll([](const FString& File) { return File.IsEmpty(); });
+
+	FAutomationTestFramework& Framework = FAutomationTestFramework::Get();
+	Framework.SetRequestedTestFilter(AUTOTEST_FILTER_MASK);
+	
+	TArray<FAutomationTestInfo> TestInfos;
+	Framework.GetValidTestNames(TestInfos);
+
+	FTestDependencyMap DependencyMap;
+	DependencyMap.Load();
+	
+	const FTestSelection Selection = DependencyMap.SelectAffectedTests(ChangedFiles, MaxAgeDays);
+	if (Selection.bFullRun)
+	{
+		UE_LOG(LogCommonAutomation, Display, TEXT("%s: full run, %s"), *FString(__FUNCTION__), *Selection.Reason);
+	}
+
+	TArray<FString> Tests;
+	int32 NumUnknown = 0, NumTotal = 0;
+	for (const FAutomationTestInfo& TestInfo: TestInfos)
+	{
+		const FString TestPath = TestInfo.GetFullTestPath();
+		if (!Filter.IsEmpty() && !TestPath.StartsWith(Filter))
+		{
+			continue;
+		}
+
+		++NumTotal;
+		// tests that never ran with dependency tracking can't be skipped
+		const bool bUnknown = DependencyMap.Find(TestPath) == nullptr;
+		NumUnknown += bUnknown ? 1 : 0;
+		if (Selection.bFullRun || bUnknown || Selection.Tests.Contains(TestPath))
+		{
+			Tests.Add(TestPath);
+		}
+	}
+	Tests.Sort();
+
+	UE_LOG(LogCommonAutomation, Display, TEXT("%s: %d changed files, selected %d of %d tests, %d tests without recorded dependencies"),
+		*FString(__FUNCTION__), ChangedFiles.Num(), Tests.Num(), NumTotal, NumUnknown);
+
+	const FString Result = FString::Join(Tests, TEXT("+"));
+	if (!Output.IsEmpty() && !FFileHelper::SaveStringToFile(Result, *Output))
+	{
+		UE_LOG(LogCommonAutomation, Error, TEXT("%s: failed to write %s"), *FString(__FUNCTION__), *Output);
+		return 1;
+	}
+
+	for (const FString& Test: Tests)
+	{
+		UE_LOG(LogCommonAutomation, Display, TEXT("Selected: %s"), *Test);
+	}
+	
+	return 0;
+}
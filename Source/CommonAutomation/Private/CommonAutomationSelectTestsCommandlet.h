@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "CommonAutomationSelectTestsCommandlet.generated.h"
+
+/**
+ * Selects automation tests affected by a change, using test dependency map recorded with CommonAutomation.TrackTestDependencies
+ * Tests missing from dependency map are always selected. If map can't be trusted for a change, every test matching the filter is selected.
+ * Selected tests are written as a '+' separated list suitable for "Automation RunTests".
+ *
+ * UnrealEditor-Cmd Project.uproject -run=CommonAutomationSelectTests -Filter=Project.Tests -ChangedFile=Changes.txt -Output=Tests.txt
+ * -Changed			comma separated list of changed files or long package names
+ * -ChangedFile		file with a changed file or long package name per line, e.g. output of git diff --name-only
+ * -Filter			select only tests which full path starts with filter
+ * -Output			file to write selected tests to, otherwise selection is only logged
+ * -MaxAgeDays		dependency map age that requires a full run, 7 days by default
+ */
+UCLASS()
+class UCommonAutomationSelectTestsCommandlet: public UCommandlet
+{
+	GENERATED_BODY()
+public:
+
+	UCommonAutomationSelectTestsCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
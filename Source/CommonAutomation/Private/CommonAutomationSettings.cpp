@@ -1,8 +1,20 @@
 #include "CommonAutomationSettings.h"
 
-#include "GameProjectUtils.h"
 #include "ModuleDescriptor.h"
+#include "Algo/BinarySearch.h"
+#include "Algo/Transform.h"
 #include "GameFramework/GameModeBase.h"
+#include "Subsystems/LocalPlayerSubsystem.h"
+#include "UObject/UObjectHash.h"
+
+#if WITH_EDITOR
+#include "GameProjectUtils.h"
+#else
+#include "ProjectDescriptor.h"
+#include "Interfaces/IPluginManager.h"
+#include "Interfaces/IProjectManager.h"
+#include "Misc/ConfigCacheIni.h"
+#endif
 
 template <>
 FString UCommonAutomationSettings::GetConfigKey<UWorldSubsystem>() const
@@ -43,6 +55,13 @@ TConstArrayView<UClass*> UCommonAutomationSettings::GetDisabledSubsystems<ULocal
 UCommonAutomationSettings::UCommonAutomationSettings(const FObjectInitializer& Initializer): Super(Initializer)
 {
 	DefaultGameMode = AGameModeBase::StaticClass();
+	StubAssetClasses = {
+		FSoftClassPath{TEXT("/Script/Engine.StaticMesh")},
+		FSoftClassPath{TEXT("/Script/Engine.Texture")},
+		FSoftClassPath{TEXT("/Script/Engine.MaterialInterface")},
+		FSoftClassPath{TEXT("/Script/Engine.SoundBase")},
+		FSoftClassPath{TEXT("/Script/Niagara.NiagaraSystem")},
+	};
 }
 
 const UCommonAutomationSettings* UCommonAutomationSettings::Get()
@@ -61,28 +80,130 @@ void UCommonAutomationSettings::PostInitProperties()
 
 	if (HasAnyFlags(RF_ClassDefaultObject))
 	{
+#if !WITH_EDITOR
+		// editor config is not loaded by game builds, settings are still read from project's DefaultEditor.ini
+		if (GEditorIni.IsEmpty())
+		{
+			FConfigCacheIni::LoadGlobalIniFile(GEditorIni, TEXT("Editor"));
+		}
+		LoadConfig();
+#endif
+		
 		FCoreDelegates::OnAllModuleLoadingPhasesComplete.AddWeakLambda(this, [this]
 		{
+			InitializeSubsystemContainers();
+			
 			InitializeToDefault(WorldSubsystemContainer, WorldSubsystems, *GetConfigKey<UWorldSubsystem>());
 			InitializeToDefault(GameInstanceSubsystemContainer, GameInstanceSubsystems, *GetConfigKey<UGameInstanceSubsystem>());
 			InitializeToDefault(LocalPlayerSubsystemContainer, LocalPlayerSubsystems, *GetConfigKey<ULocalPlayerSubsystem>());
+
+			// modules loaded from now on are handled incrementally
+			ModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddUObject(this, &ThisClass::HandleModulesChanged);
 		});
 	}
 }
 
-const TArray<FName>& UCommonAutomationSettings::GetProjectModules()
+void UCommonAutomationSettings::BeginDestroy()
 {
-	static TArray<FModuleContextInfo, TInlineAllocator<6>> GameModules{GameProjectUtils::GetCurrentProjectModules()};
-	static TArray<FModuleContextInfo, TInlineAllocator<32>> PluginModules{GameProjectUtils::GetCurrentProjectPluginModules()};
-			
-	static TArray<FName> ModuleNames = []() -> TArray<FName>
+	if (ModulesChangedHandle.IsValid())
+	{
+		FModuleManager::Get().OnModulesChanged().Remove(ModulesChangedHandle);
+		ModulesChangedHandle.Reset();
+	}
+	
+	Super::BeginDestroy();
+}
+
+void UCommonAutomationSettings::InitializeSubsystemContainers()
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(UCommonAutomationSettings_InitializeSubsystemContainers);
+	using namespace UE::Automation;
+	
+	WorldSubsystemContainer			= FSubsystemContainer{UWorldSubsystem::StaticClass()};
+	GameInstanceSubsystemContainer	= FSubsystemContainer{UGameInstanceSubsystem::StaticClass()};
+	LocalPlayerSubsystemContainer	= FSubsystemContainer{ULocalPlayerSubsystem::StaticClass()};
+	
+	// single scan per subsystem type, classification only inspects class package name
+	for (FSubsystemContainer* Container: {&WorldSubsystemContainer, &GameInstanceSubsystemContainer, &LocalPlayerSubsystemContainer})
+	{
+		TArray<UClass*> DerivedClasses;
+		GetDerivedClasses(Container->GetBaseType(), DerivedClasses, true);
+
+		for (UClass* Class: DerivedClasses)
+		{
+			if (Container->IsSubsystemClass(Class))
+			{
+				Container->AddSubsystem(Class, IsProjectModuleClass(Class));
+			}
+		}
+	}
+}
+
+void UCommonAutomationSettings::HandleModulesChanged(FName ModuleName, EModuleChangeReason Reason)
+{
+	if (Reason != EModuleChangeReason::ModuleLoaded)
+	{
+		return;
+	}
+
+	// native classes are registered by the time ModuleLoaded is broadcast, all of them are outered to /Script/<Module> package
+	const UPackage* ModulePackage = FindPackage(nullptr, *WriteToString<128>(TEXT("/Script/"), ModuleName));
+	if (ModulePackage == nullptr)
+	{
+		return;
+	}
+
+	TArray<UObject*> ModuleObjects;
+	GetObjectsWithOuter(ModulePackage, ModuleObjects, false);
+
+	TArray<UClass*> ModuleClasses;
+	for (UObject* Object: ModuleObjects)
 	{
-		TArray<FName> OutModuleNames;
+		if (UClass* Class = Cast<UClass>(Object))
+		{
+			ModuleClasses.Add(Class);
+		}
+	}
+
+	if (!ModuleClasses.IsEmpty())
+	{
+		AddModuleSubsystems(WorldSubsystemContainer, WorldSubsystems, ModuleClasses);
+		AddModuleSubsystems(GameInstanceSubsystemContainer, GameInstanceSubsystems, ModuleClasses);
+		AddModuleSubsystems(LocalPlayerSubsystemContainer, LocalPlayerSubsystems, ModuleClasses);
+	}
+}
+
+const TSet<FName>& UCommonAutomationSettings::GetProjectModules()
+{
+	static TSet<FName> ModuleNames = []() -> TSet<FName>
+	{
+#if WITH_EDITOR
+		const TArray<FModuleContextInfo> GameModules = GameProjectUtils::GetCurrentProjectModules();
+		const TArray<FModuleContextInfo> PluginModules = GameProjectUtils::GetCurrentProjectPluginModules();
+		
+		TSet<FName> OutModuleNames;
 		OutModuleNames.Reserve(GameModules.Num() + PluginModules.Num());
 
 		auto Trans = [](const FModuleContextInfo& Module) { return FName{Module.ModuleName}; };
 		Algo::Transform(GameModules, OutModuleNames, Trans);
 		Algo::Transform(PluginModules, OutModuleNames, Trans);
+#else
+		// game builds can't scan project source, use modules listed by project and project plugin descriptors instead
+		TSet<FName> OutModuleNames;
+		auto Trans = [](const FModuleDescriptor& Module) { return Module.Name; };
+		
+		if (const FProjectDescriptor* Project = IProjectManager::Get().GetCurrentProject())
+		{
+			Algo::Transform(Project->Modules, OutModuleNames, Trans);
+		}
+		for (const TSharedRef<IPlugin>& Plugin: IPluginManager::Get().GetEnabledPlugins())
+		{
+			if (Plugin->GetLoadedFrom() == EPluginLoadedFrom::Project)
+			{
+				Algo::Transform(Plugin->GetDescriptor().Modules, OutModuleNames, Trans);
+			}
+		}
+#endif
 
 		return OutModuleNames;
 	}();
@@ -90,42 +211,61 @@ const TArray<FName>& UCommonAutomationSettings::GetProjectModules()
 	return ModuleNames;
 }
 
-bool UCommonAutomationSettings::IsProjectModuleClass(UClass* Class)
+bool UCommonAutomationSettings::IsProjectModuleClass(const UClass* Class)
 {
-	const FString ClassPath = Class->GetClassPathName().ToString();
-	
-	FRegexPattern Regex{TEXT("\\/Script\\/([A-Z][A-Za-z]*)\\.")};
-	FRegexMatcher Matcher{Regex, ClassPath};
+	const FName ModuleName = UE::Automation::GetClassModuleName(Class);
+	return !ModuleName.IsNone() && GetProjectModules().Contains(ModuleName);
+}
+
+FName UE::Automation::GetClassModuleName(const UClass* Class)
+{
+	check(Class);
+	if (!Class->HasAnyClassFlags(CLASS_Native))
+	{
+		return NAME_None;
+	}
+
+	// native class package is always /Script/<Module>
+	TStringBuilder<128> PackageName;
+	Class->GetPackage()->GetFName().ToString(PackageName);
 	
-	if (Matcher.FindNext())
+	const FStringView ScriptPrefix{TEXT("/Script/")};
+	if (!PackageName.ToView().StartsWith(ScriptPrefix))
 	{
-		const FName ModuleName{Matcher.GetCaptureGroup(1)};
-		return GetProjectModules().Contains(ModuleName);
+		return NAME_None;
 	}
 
-	checkNoEntry();
-	return false;
+	return FName{PackageName.ToView().RightChop(ScriptPrefix.Len())};
 }
 
 UE::Automation::FSubsystemContainer::FSubsystemContainer(UClass* InBaseType)
 	: BaseType(InBaseType)
 {
-	// initialize all subsystems
-	GetDerivedClasses(BaseType, AllSubsystems, true);
-	for (auto It = AllSubsystems.CreateIterator(); It; ++It)
+	check(BaseType);
+}
+
+bool UE::Automation::FSubsystemContainer::IsSubsystemClass(const UClass* Class) const
+{
+	return Class != BaseType && Class->IsChildOf(BaseType) && !Class->HasAnyClassFlags(CLASS_Abstract);
+}
+
+bool UE::Automation::FSubsystemContainer::AddSubsystem(UClass* SubsystemClass, bool bProjectModuleClass)
+{
+	// keep subsystems sorted by pointer, same as initial scan did
+	const int32 Index = Algo::LowerBound(AllSubsystems, SubsystemClass);
+	if (AllSubsystems.IsValidIndex(Index) && AllSubsystems[Index] == SubsystemClass)
 	{
-		if ((*It)->HasAnyClassFlags(EClassFlags::CLASS_Abstract))
-		{
-			It.RemoveCurrentSwap();
-		}
+		return false;
 	}
-	Algo::Sort(AllSubsystems);
 
-	// find project module subsystems
-	Algo::CopyIf(AllSubsystems, ProjectModuleSubsystems, [](UClass* SubsystemClass)
+	AllSubsystems.Insert(SubsystemClass, Index);
+	if (bProjectModuleClass)
 	{
-		return UCommonAutomationSettings::IsProjectModuleClass(SubsystemClass);
-	});
+		ProjectModuleSubsystems.Add(SubsystemClass);
+	}
+	
+	MarkDirty();
+	return true;
 }
 
 #if WITH_EDITOR
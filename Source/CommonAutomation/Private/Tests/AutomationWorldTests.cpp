@@ -1,21 +1,59 @@
 
 #include "AutomationWorldTests.h"
 
+#include "AutomationActorDescQuery.h"
+#include "AutomationAssetStubs.h"
+#include "AutomationBenchmark.h"
 #include "AutomationCommon.h"
+#include "AutomationFrameTiming.h"
+#include "AutomationLoadManifest.h"
+#include "AutomationLoadTracker.h"
+#include "AutomationPerfHistory.h"
+#include "AutomationSyncLoadDetector.h"
+#include "AutomationTestDependencies.h"
+#include "AutomationTickProfiler.h"
+#include "AutomationTraceCapture.h"
 #include "AutomationTestDefinition.h"
 #include "AutomationWorld.h"
+#include "AutomationWorldFixture.h"
+#include "AutomationWorldSweep.h"
+#include "AutomationWorldTask.h"
+#include "AutomationWorldUsage.h"
+#include "CommonAutomationForkServerCommandlet.h"
 #include "CommonAutomationSettings.h"
 #include "EngineUtils.h"
 #include "GameInstanceAutomationSupport.h"
 #include "NavigationSystem.h"
 #include "AI/NavigationSystemBase.h"
+#include "Algo/AllOf.h"
+#include "Algo/AnyOf.h"
+#include "Algo/Count.h"
+#include "Algo/NoneOf.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Components/BoxComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
 #include "GameFramework/GameMode.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
+#include "Materials/MaterialInterface.h"
 #include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeExit.h"
 #include "UObject/GarbageCollection.h"
+#include "UObject/LinkerInstancingContext.h"
 #include "WorldPartition/WorldPartition.h"
+#include "WorldPartition/DataLayer/DataLayerAsset.h"
+#include "WorldPartition/DataLayer/DataLayerInstance.h"
+#include "WorldPartition/DataLayer/DataLayerManager.h"
+#include "WorldPartition/DataLayer/WorldDataLayers.h"
+#if WITH_EDITOR
+#include "DataLayer/DataLayerEditorSubsystem.h"
+#endif
 
-const EAutomationTestFlags AutomationTestFlags = EAutomationTestFlags::EngineFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::CriticalPriority;
+const EAutomationTestFlags AutomationTestFlags = EAutomationTestFlags::EngineFilter | EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::CriticalPriority;
 
 namespace UE::Private
 {
@@ -353,6 +391,7 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_NavigationSystemTest, "CommonA
 
 bool FAutomationWorld_NavigationSystemTest::RunTest(const FString& Parameters)
 {
+#if WITH_EDITOR
 	{
 		FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateEditorWorld(EWorldInitFlags::InitScene | EWorldInitFlags::InitNavigation);
 
@@ -360,6 +399,7 @@ bool FAutomationWorld_NavigationSystemTest::RunTest(const FString& Parameters)
 		UTEST_TRUE("Navigation system is created for editor world", IsValid(NavSys));
 		UTEST_TRUE("Navigation system is initialized for world", NavSys->IsInitialized() && NavSys->IsWorldInitDone());
 	}
+#endif
 
 	{
 		FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld(EWorldInitFlags::InitScene | EWorldInitFlags::InitNavigation);
@@ -375,7 +415,9 @@ bool FAutomationWorld_NavigationSystemTest::RunTest(const FString& Parameters)
 
 BEGIN_SIMPLE_AUTOMATION_TEST(FAutomationWorldFlagsTests, "CommonAutomation.AutomationWorld.Flags", AutomationTestFlags)
 	void TestFlag(EWorldInitFlags Flag, TFunction<bool(UWorld*)> Pred);
+#if WITH_EDITOR
 	void TestEditorFlag(EWorldInitFlags Flag, TFunction<bool(UWorld*)> Pred);
+#endif
 END_SIMPLE_AUTOMATION_TEST(FAutomationWorldFlagsTests)
 
 void FAutomationWorldFlagsTests::TestFlag(EWorldInitFlags Flag, TFunction<bool(UWorld*)> Pred)
@@ -391,6 +433,7 @@ void FAutomationWorldFlagsTests::TestFlag(EWorldInitFlags Flag, TFunction<bool(U
 	}
 }
 
+#if WITH_EDITOR
 void FAutomationWorldFlagsTests::TestEditorFlag(EWorldInitFlags Flag, TFunction<bool(UWorld*)> Pred)
 {
 	{
@@ -403,6 +446,7 @@ void FAutomationWorldFlagsTests::TestEditorFlag(EWorldInitFlags Flag, TFunction<
 		TestFalse(FString::Printf(TEXT("Flag %d not specified"), static_cast<uint32>(Flag)), Pred(WorldPtr->GetWorld()));
 	}
 }
+#endif
 
 bool FAutomationWorldFlagsTests::RunTest(const FString& Parameters)
 {
@@ -444,6 +488,8 @@ bool FAutomationWorldFlagsTests::RunTest(const FString& Parameters)
 	TestFlag(EWorldInitFlags::InitFX, [](UWorld* World) {
 		return World->FXSystem != nullptr;
 	});
+#if WITH_EDITOR
+	// world partition is created for new worlds only in editor builds
 	TestFlag(EWorldInitFlags::InitWorldPartition, [](UWorld* World) {
 		UWorldPartition* WorldPartition = World->GetWorldPartition();
 		return WorldPartition && WorldPartition->IsInitialized() && WorldPartition->AlwaysLoadedActors == nullptr;
@@ -456,6 +502,1014 @@ bool FAutomationWorldFlagsTests::RunTest(const FString& Parameters)
 		UWorldPartition* WorldPartition = World->GetWorldPartition();
 		return WorldPartition && WorldPartition->bEnableStreaming == false;
 	});
+#endif
+
+	return !HasAnyErrors();
+}
+
+BEGIN_DEFINE_AUTOMATION_WORLD_SPEC(FAutomationWorldFixtureSpec, "CommonAutomation.AutomationWorld.Fixture", AutomationTestFlags)
+	int32 NumResets = 0;
+END_DEFINE_AUTOMATION_WORLD_SPEC(FAutomationWorldFixtureSpec)
+
+void FAutomationWorldFixtureSpec::Define()
+{
+	UseWorldFixture(FWorldInitParams::WithBeginPlay, [this](FAutomationWorld&) { ++NumResets; });
+
+	It("Creates fixture world", [this]
+	{
+		TestTrue("Fixture world is valid", WorldFixture.IsValid() && FAutomationWorld::Exists());
+		TestTrue("Actor is spawned", IsValid(WorldFixture->SpawnActor()));
+	});
+
+	It("Resets fixture world in place", [this]
+	{
+		const FObjectKey FixtureWorld{WorldFixture->GetWorld()};
+		const TWeakObjectPtr<AActor> SpawnedActor = WorldFixture->SpawnActor();
+		const int32 NumResetsBefore = NumResets;
+
+		// same reset that runs after every It block
+		WorldFixture.ResetWorld();
+		
+		TestTrue("Fixture world is the same", WorldFixture.IsValid() && FixtureWorld == FObjectKey{WorldFixture->GetWorld()});
+		TestTrue("Actor spawned by the test is destroyed", !SpawnedActor.IsValid() || !IsValid(SpawnedActor.Get()));
+		TestEqual("Reset callback is called", NumResets, NumResetsBefore + 1);
+		TestTrue("Setup keeps existing fixture world", FixtureWorld == FObjectKey{WorldFixture.Setup().GetWorld()});
+	});
+}
+
+namespace UE::Private
+{
+	// coroutine parameters are stored in coroutine frame, unlike lambda captures
+	UE::Automation::FWorldTask RunWorldTaskSteps(FAutomationWorld& World, int32& Step, const bool& bCondition)
+	{
+		Step = 1;
+		co_await World.Frames(5);
+		Step = 2;
+		co_await World.Until([&bCondition] { return bCondition; });
+		Step = 3;
+		co_await World.Seconds(1.0);
+		Step = 4;
+	}
+
+	UE::Automation::FWorldTask CancelSiblingTask(FAutomationWorld& World, TOptional<UE::Automation::FWorldTask>& Sibling)
+	{
+		co_await World.Frames(1);
+		Sibling.Reset();
+	}
+
+	UE::Automation::FWorldTask WaitUntilTask(FAutomationWorld& World, const bool& bCondition, bool& bResumed)
+	{
+		co_await World.Until([&bCondition] { return bCondition; });
+		bResumed = true;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_WorldTaskTest, "CommonAutomation.AutomationWorld.WorldTask", AutomationTestFlags)
+
+bool FAutomationWorld_WorldTaskTest::RunTest(const FString& Parameters)
+{
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld();
+
+	int32 Step = 0;
+	bool bCondition = false;
+	UE::Automation::FWorldTask Task = UE::Private::RunWorldTaskSteps(*ScopedWorld, Step, bCondition);
+
+	UTEST_EQUAL("Task starts immediately", Step, 1);
+	UTEST_TRUE("Task is suspended", Task.IsSuspended());
+	
+	ScopedWorld->TickWorld(4);
+	UTEST_EQUAL("Task waits for frames", Step, 1);
+	ScopedWorld->TickWorld(1);
+	UTEST_EQUAL("Task is resumed after frames", Step, 2);
+
+	ScopedWorld->TickWorld(10);
+	UTEST_EQUAL("Task waits for predicate", Step, 2);
+	bCondition = true;
+	ScopedWorld->TickWorld(1);
+	UTEST_EQUAL("Task is resumed after predicate", Step, 3);
+
+	UTEST_TRUE("Pending tasks are finished", ScopedWorld->RunTasks());
+	UTEST_EQUAL("Task is resumed after world time", Step, 4);
+	UTEST_TRUE("Task is done", Task.IsDone());
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_WorldTaskCancelTest, "CommonAutomation.AutomationWorld.WorldTaskCancel", AutomationTestFlags)
+
+bool FAutomationWorld_WorldTaskCancelTest::RunTest(const FString& Parameters)
+{
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld();
+
+	bool bCondition = false;
+	bool bSiblingResumed = false;
+	TOptional<UE::Automation::FWorldTask> Sibling;
+	Sibling.Emplace(UE::Private::WaitUntilTask(*ScopedWorld, bCondition, bSiblingResumed));
+	UE::Automation::FWorldTask Task = UE::Private::CancelSiblingTask(*ScopedWorld, Sibling);
+	UTEST_TRUE("Sibling is suspended", Sibling->IsSuspended());
+
+	// both tasks become ready on the same frame, frame waits are resumed before predicate waits
+	bCondition = true;
+	ScopedWorld->TickWorld(1);
+	UTEST_TRUE("Task is done", Task.IsDone());
+	UTEST_FALSE("Sibling is destroyed", Sibling.IsSet());
+	UTEST_FALSE("Cancelled sibling is not resumed", bSiblingResumed);
+	UTEST_TRUE("No tasks are pending", ScopedWorld->RunTasks());
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationBenchmark_StatsTest, "CommonAutomation.Benchmark.Stats", AutomationTestFlags)
+
+bool FAutomationBenchmark_StatsTest::RunTest(const FString& Parameters)
+{
+	const TArray<double> Samples{1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 1000.0};
+
+	const UE::Automation::FBenchmarkStats Stats = UE::Automation::ComputeBenchmarkStats(Samples, 3.0);
+	UTEST_EQUAL("Outlier is rejected", Stats.NumOutliers, 1);
+	UTEST_EQUAL("Samples are counted after rejection", Stats.NumSamples, 10);
+	UTEST_EQUAL("Min", Stats.Min, 1.0);
+	UTEST_EQUAL("Max", Stats.Max, 10.0);
+	UTEST_EQUAL("Median", Stats.Median, 5.5);
+	UTEST_EQUAL("P95", Stats.P95, 10.0);
+
+	const UE::Automation::FBenchmarkStats RawStats = UE::Automation::ComputeBenchmarkStats(Samples, 0.0);
+	UTEST_EQUAL("Outliers are kept when rejection is disabled", RawStats.NumOutliers, 0);
+	UTEST_EQUAL("Max includes outlier", RawStats.Max, 1000.0);
+	
+	return !HasAnyErrors();
+}
+
+BEGIN_AUTOMATION_BENCHMARK(FAutomationBenchmark_RunTest, "CommonAutomation.Benchmark.Run", AutomationTestFlags)
+	int32 NumIterations = 0;
+	int32 NumSpawnedActors = 0;
+
+	virtual bool RunTest(const FString& Parameters) override
+	{
+		NumIterations = NumSpawnedActors = 0;
+		const FString ArtifactPath = GetArtifactPath(Parameters);
+		IFileManager::Get().Delete(*ArtifactPath, false, true, true);
+		
+		FAutomationBenchmarkBase::RunTest(Parameters);
+
+		TestEqual("Warmup and timed iterations are executed", NumIterations, Config.NumWarmup + Config.NumRepetitions);
+		TestEqual("Body runs against sweep parameter", NumSpawnedActors, NumIterations * FCString::Atoi(*Parameters));
+		TestTrue("Benchmark artifact is written", IFileManager::Get().FileExists(*ArtifactPath));
+		TestFalse("Benchmark world is destroyed", FAutomationWorld::Exists());
+		
+		return !HasAnyErrors();
+	}
+END_AUTOMATION_BENCHMARK(FAutomationBenchmark_RunTest)
+
+void FAutomationBenchmark_RunTest::Define()
+{
+	Config.WorldParams.Emplace(FWorldInitParams::WithBeginPlay);
+	Config.NumWarmup = 2;
+	Config.NumRepetitions = 5;
+	Config.SweepParams = {TEXT("1"), TEXT("10")};
+	Config.Body = [this](FAutomationWorld& World, const FString& Param)
+	{
+		++NumIterations;
+		for (int32 Index = 0; Index < FCString::Atoi(*Param); ++Index)
+		{
+			World.SpawnActor();
+			++NumSpawnedActors;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_TickProfilingTest, "CommonAutomation.AutomationWorld.TickProfiling", AutomationTestFlags)
+
+bool FAutomationWorld_TickProfilingTest::RunTest(const FString& Parameters)
+{
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld();
+	
+	AActor* Actor = ScopedWorld->SpawnActor();
+	Actor->PrimaryActorTick.bCanEverTick = true;
+	Actor->RegisterAllActorTickFunctions(true, false);
+	Actor->SetActorTickEnabled(true);
+	
+	ScopedWorld->StartTickProfiling();
+	ScopedWorld->TickWorld(10);
+
+	const UE::Automation::FTickProfiler* Profiler = ScopedWorld->GetTickProfiler();
+	UTEST_TRUE("Tick profiler is active", Profiler != nullptr);
+	UTEST_EQUAL("Tick profiler counts frames", Profiler->GetNumFrames(), 10);
+	
+	const TArray<UE::Automation::FTickProfileEntry> Instances = Profiler->GetTopInstances(INDEX_NONE);
+	const UE::Automation::FTickProfileEntry* ActorEntry = Instances.FindByPredicate([Actor](const UE::Automation::FTickProfileEntry& Entry)
+	{
+		return Entry.Name == Actor->GetName();
+	});
+	UTEST_TRUE("Actor tick is attributed", ActorEntry != nullptr);
+	UTEST_EQUAL("Actor ticks every frame", ActorEntry->NumTicks, 10);
+
+	ScopedWorld->StopTickProfiling();
+	UTEST_TRUE("Original tick function is restored", Actor->PrimaryActorTick.IsTickFunctionRegistered());
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_SpawnActorsTest, "CommonAutomation.AutomationWorld.SpawnActors", AutomationTestFlags)
+
+bool FAutomationWorld_SpawnActorsTest::RunTest(const FString& Parameters)
+{
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld();
+
+	const TArray<AActor*> Actors = ScopedWorld->SpawnActors(16);
+	UTEST_EQUAL("All actors are spawned", Actors.Num(), 16);
+	UTEST_TRUE("Actors are fully spawned", Algo::AllOf(Actors, [](const AActor* Actor) { return IsValid(Actor) && Actor->HasActorBegunPlay(); }));
+
+	const TArray<FTransform> Transforms{FTransform{FVector{100.0, 0.0, 0.0}}, FTransform{FVector{200.0, 0.0, 0.0}}};
+	const TArray<AActor*> PlacedActors = ScopedWorld->SpawnActors(Transforms, AActor::StaticClass(), {}, EBatchSpawnFlags::SkipOverlapUpdates);
+	UTEST_EQUAL("Actor is spawned for every transform", PlacedActors.Num(), Transforms.Num());
+
+	const TArray<USceneComponent*> Components = UE::Automation::CreateActorComponents<USceneComponent>(ScopedWorld->GetWorld(), Actors);
+	UTEST_EQUAL("Component is created for every actor", Components.Num(), Actors.Num());
+	UTEST_TRUE("Components are registered", Algo::AllOf(Components, [](const USceneComponent* Component) { return Component->IsRegistered(); }));
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_FrameTimingTest, "CommonAutomation.AutomationWorld.FrameTiming", AutomationTestFlags)
+
+bool FAutomationWorld_FrameTimingTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+	
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld();
+	ScopedWorld->TickWorld(5);
+
+	const FFrameTimingRecorder& FrameTimings = ScopedWorld->GetFrameTimings();
+	UTEST_EQUAL("Every frame is recorded", FrameTimings.Num(), 5);
+	UTEST_TRUE("Last frame is the most recent one", FrameTimings.GetLastFrame()->Frame > FrameTimings.GetFrame(0).Frame);
+	UTEST_TRUE("Percentiles are ordered", FrameTimings.GetPercentile(EFrameTimingStat::GameThread, 0.5) <= FrameTimings.GetPercentile(EFrameTimingStat::GameThread, 0.99));
+	UTEST_TRUE("Max is the largest value", FrameTimings.GetPercentile(EFrameTimingStat::GameThread, 0.99) <= FrameTimings.GetMax(EFrameTimingStat::GameThread));
+	UTEST_TRUE("No hitches without threshold", FrameTimings.GetHitches().IsEmpty());
+
+	// any frame exceeds threshold
+	ScopedWorld->SetHitchThreshold(UE_SMALL_NUMBER, true);
+	ScopedWorld->TickWorld(2);
+	UTEST_EQUAL("Hitch is recorded for every frame", FrameTimings.GetHitches().Num(), 2);
+	UTEST_TRUE("Hitch tick group is known", FrameTimings.GetHitches().Last().SlowestTickGroup != TG_MAX);
+
+	ScopedWorld->SetHitchThreshold(0.0);
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_TraceCaptureTest, "CommonAutomation.AutomationWorld.TraceCapture", AutomationTestFlags)
+
+bool FAutomationWorld_TraceCaptureTest::RunTest(const FString& Parameters)
+{
+	{
+		UE::Automation::FTraceCapture Capture{0.0};
+		UTEST_FALSE("Trace is discarded without hitches and budget", Capture.ShouldWrite());
+		UTEST_TRUE("Discarded trace is not written", Capture.Finish(GetTestFullName()).IsEmpty());
+	}
+
+	{
+		UE::Automation::FTraceCapture Capture{UE_SMALL_NUMBER};
+		FPlatformProcess::Sleep(0.01f);
+		UTEST_TRUE("Trace is written when budget is exceeded", Capture.ShouldWrite());
+	}
+
+	{
+		UE::Automation::FTraceCapture Capture{0.0};
+		Capture.MarkHitch(1);
+		UTEST_TRUE("Trace is written on hitch", Capture.ShouldWrite());
+	}
+
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld();
+	ScopedWorld->StartTraceCapture();
+	ScopedWorld->TickWorld(1);
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationPerfHistoryTest, "CommonAutomation.PerfHistory", AutomationTestFlags)
+
+bool FAutomationPerfHistoryTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+	
+	const FString Filename = FPaths::ProjectIntermediateDir() / TEXT("CommonAutomation") / TEXT("PerfHistoryTest.bin");
+	IFileManager::Get().Delete(*Filename);
+	ON_SCOPE_EXIT { IFileManager::Get().Delete(*Filename); };
+
+	{
+		FPerfHistory History{Filename};
+		for (int32 Index = 0; Index < 6; ++Index)
+		{
+			FPerfHistoryEntry Entry;
+			Entry.TestName = GetTestFullName();
+			Entry.WorldCreationMs = 10.0 + Index % 2;
+			Entry.TickP50Ms = 1.0;
+			UTEST_TRUE("Entry is appended", History.Append(Entry));
+		}
+	}
+
+	FPerfHistory History{Filename};
+	UTEST_TRUE("History is loaded", History.Load());
+	UTEST_EQUAL("All entries are loaded", History.GetEntries().Num(), 6);
+
+	const TArray<const FPerfHistoryEntry*> TestHistory = History.GetTestHistory(GetTestFullName(), 20);
+	UTEST_EQUAL("Test history is found", TestHistory.Num(), 6);
+
+	FPerfHistoryEntry Entry;
+	Entry.TestName = GetTestFullName();
+	Entry.WorldCreationMs = 10.5;
+	Entry.TickP50Ms = 1.0;
+	UTEST_TRUE("No regressions for a stable entry", FPerfHistory::FindRegressions(Entry, TestHistory).IsEmpty());
+
+	Entry.WorldCreationMs = 20.0;
+	const TArray<FPerfRegression> Regressions = FPerfHistory::FindRegressions(Entry, TestHistory);
+	UTEST_EQUAL("Regression is found", Regressions.Num(), 1);
+	UTEST_TRUE("World creation regressed", Regressions[0].Metric == EPerfMetric::WorldCreation);
+
+	Entry.WorldCreationMs = 10.5;
+	Entry.GarbageCollectionMs = 0.01;
+	UTEST_TRUE("Metric with constant history doesn't regress on noise", FPerfHistory::FindRegressions(Entry, TestHistory).IsEmpty());
+	
+	Entry.GarbageCollectionMs = 5.0;
+	const TArray<FPerfRegression> ConstantRegressions = FPerfHistory::FindRegressions(Entry, TestHistory);
+	UTEST_TRUE("Metric with constant history regresses above absolute minimum", ConstantRegressions.Num() == 1 && ConstantRegressions[0].Metric == EPerfMetric::GarbageCollection);
+	
+	// file cut inside the header is not a history file
+	UTEST_TRUE("Truncated file is written", FFileHelper::SaveArrayToFile(TArray<uint8>{0x43, 0x41}, *Filename));
+	UTEST_FALSE("Truncated header is rejected", History.Load());
+	UTEST_TRUE("No entries are parsed from truncated file", History.GetEntries().IsEmpty());
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_UsageProbeTest, "CommonAutomation.AutomationWorld.UsageProbe", AutomationTestFlags)
+
+bool FAutomationWorld_UsageProbeTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+
+	const EWorldInitFlags Recommended = FWorldUsageProbe::RecommendFlags(EWorldUsage::Collision | EWorldUsage::LocalPlayer, EWorldInitFlags::WithLocalPlayer | EWorldInitFlags::InitAI);
+	UTEST_TRUE("Collision requires physics scene", EnumHasAllFlags(Recommended, EWorldInitFlags::InitPhysics | EWorldInitFlags::InitCollision));
+	UTEST_TRUE("Local player requires game instance", EnumHasAllFlags(Recommended, EWorldInitFlags::CreateGameInstance | EWorldInitFlags::CreateLocalPlayer));
+	UTEST_TRUE("Flags not derived from usage are kept", EnumHasAllFlags(Recommended, EWorldInitFlags::StartPlay));
+	UTEST_FALSE("Unused flags are removed", EnumHasAnyFlags(Recommended, EWorldInitFlags::InitAI));
+	
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld(EWorldInitFlags::InitAI | EWorldInitFlags::InitNavigation);
+	ScopedWorld->StartUsageProbe();
+	ScopedWorld->TickWorld(1);
+
+	const FWorldUsageProbe* Probe = ScopedWorld->GetUsageProbe();
+	UTEST_TRUE("Usage probe is active", Probe != nullptr);
+	UTEST_TRUE("Unused systems are reported", EnumHasAllFlags(Probe->GetUnusedFlags(), EWorldInitFlags::InitAI | EWorldInitFlags::InitNavigation));
+
+	FAutomationWorldInitParams Params{EWorldType::Game, EWorldInitFlags::WithGameInstance};
+	Params.EnableSubsystem<UTestWorldSubsystem>().EnableSubsystem<UTestGameInstanceSubsystem>();
+	ScopedWorld.Reset();
+	ScopedWorld = FAutomationWorld::CreateWorld(Params);
+	ScopedWorld->StartUsageProbe();
+	UTEST_TRUE("Test world subsystem is created", ScopedWorld->GetSubsystem<UTestWorldSubsystem>() != nullptr);
+	ScopedWorld->TickWorld(1);
+
+	Probe = ScopedWorld->GetUsageProbe();
+	const TArray<UClass*> UnusedSubsystems = Probe->GetUnusedSubsystems();
+	UTEST_TRUE("Subsystem that was never accessed is reported", UnusedSubsystems.Contains(UTestGameInstanceSubsystem::StaticClass()));
+	UTEST_FALSE("Accessed subsystem is not reported", UnusedSubsystems.Contains(UTestWorldSubsystem::StaticClass()));
+
+	const FString Suggested = Probe->GetSuggestedInitParams();
+	UTEST_TRUE("Suggestion spells out init flags", Suggested.Contains(TEXT("EWorldInitFlags::")));
+	UTEST_TRUE("Suggestion keeps accessed subsystem", Suggested.Contains(UTestWorldSubsystem::StaticClass()->GetName()));
+	UTEST_FALSE("Suggestion drops unused subsystem", Suggested.Contains(UTestGameInstanceSubsystem::StaticClass()->GetName()));
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_LazySceneTest, "CommonAutomation.AutomationWorld.LazyScene", AutomationTestFlags)
+
+bool FAutomationWorld_LazySceneTest::RunTest(const FString& Parameters)
+{
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld(EWorldInitFlags::LazyScene);
+	UWorld* World = ScopedWorld->GetWorld();
+	UTEST_TRUE("Scene is not created during initialization", World->Scene == nullptr);
+
+	ScopedWorld->SpawnActor();
+	ScopedWorld->TickWorld(1);
+	UTEST_TRUE("Scene is not created for actors without primitives", World->Scene == nullptr);
+
+	ScopedWorld->SpawnActor<AStaticMeshActor>();
+	UTEST_TRUE("Scene is created for a visible primitive", World->Scene != nullptr);
+
+	ScopedWorld.Reset();
+	ScopedWorld = FAutomationWorld::CreateGameWorld(EWorldInitFlags::LazyScene | EWorldInitFlags::InitPhysics | EWorldInitFlags::InitCollision);
+	World = ScopedWorld->GetWorld();
+	UTEST_TRUE("Physics scene is created with lazy scene", World->GetPhysicsScene() != nullptr);
+
+	AActor* Actor = ScopedWorld->SpawnActor();
+	UBoxComponent* Box = NewObject<UBoxComponent>(Actor);
+	Box->SetBoxExtent(FVector{100.0});
+	Box->SetCollisionProfileName(UCollisionProfile::BlockAll_ProfileName);
+	Actor->SetRootComponent(Box);
+	Box->RegisterComponent();
+
+	FHitResult Hit;
+	const bool bHit = World->LineTraceSingleByChannel(Hit, FVector{-500.0, 0.0, 0.0}, FVector{500.0, 0.0, 0.0}, ECC_Visibility);
+	UTEST_TRUE("Trace hits collision in lazy scene world", bHit && Hit.GetActor() == Actor);
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationTestDependenciesTest, "CommonAutomation.TestDependencies", AutomationTestFlags)
+
+bool FAutomationTestDependenciesTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+	
+	{
+		FPackageLoadTracker Tracker{true};
+		FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld();
+		ScopedWorld->SpawnActor<AStaticMeshActor>();
+		Tracker.Stop();
+		
+		UTEST_TRUE("Instantiated class is tracked", Tracker.GetInstantiatedClasses().Contains(FTopLevelAssetPath{AStaticMeshActor::StaticClass()}));
+		UTEST_TRUE("Class module is tracked", Tracker.GetTouchedModules().Contains(FName{TEXT("Engine")}));
+	}
+	
+	const FString Filename = FPaths::ProjectIntermediateDir() / TEXT("CommonAutomation") / TEXT("TestDependenciesTest.json");
+	IFileManager::Get().Delete(*Filename);
+	ON_SCOPE_EXIT { IFileManager::Get().Delete(*Filename); };
+
+	{
+		FTestDependencyMap DependencyMap{Filename};
+		UTEST_TRUE("Empty map requests full run", DependencyMap.SelectAffectedTests({TEXT("/Game/Maps/A")}).bFullRun);
+		
+		FTestDependencies MapTest;
+		MapTest.Packages.Add(TEXT("/Game/Maps/A"));
+		MapTest.Modules.Add(TEXT("Engine"));
+		DependencyMap.Record(TEXT("Tests.Map"), MoveTemp(MapTest));
+		
+		FTestDependencies OtherTest;
+		OtherTest.Packages.Add(TEXT("/Game/Data/B"));
+		DependencyMap.Record(TEXT("Tests.Other"), MoveTemp(OtherTest));
+		
+		FTestDependencies MapTestSecondWorld;
+		MapTestSecondWorld.Packages.Add(TEXT("/Game/Data/C"));
+		DependencyMap.Record(TEXT("Tests.Map"), MoveTemp(MapTestSecondWorld));
+		UTEST_EQUAL("Second world of the same test extends dependencies", DependencyMap.Find(TEXT("Tests.Map"))->Packages.Num(), 2);
+		UTEST_TRUE("Map is saved", DependencyMap.Save());
+	}
+
+	FTestDependencyMap DependencyMap{Filename};
+	UTEST_TRUE("Map is loaded", DependencyMap.Load());
+	UTEST_EQUAL("All tests are loaded", DependencyMap.GetTests().Num(), 2);
+
+	const FTestSelection Selection = DependencyMap.SelectAffectedTests({TEXT("/Game/Data/C")});
+	UTEST_FALSE("Package change doesn't require full run", Selection.bFullRun);
+	UTEST_TRUE("Only dependent test is selected", Selection.Tests.Num() == 1 && Selection.Tests[0] == TEXT("Tests.Map"));
+	UTEST_TRUE("Unrelated package selects nothing", DependencyMap.SelectAffectedTests({TEXT("/Game/Data/D")}).Tests.IsEmpty());
+	UTEST_TRUE("Unknown file requests full run", DependencyMap.SelectAffectedTests({TEXT("Config/DefaultGame.ini")}).bFullRun);
+
+	{
+		// world package is instanced under /Temp, dependency is recorded by the original package name
+		const FName EntryPackage{TEXT("/Engine/Maps/Entry")};
+		FAutomationWorldPtr ScopedWorld = FAutomationWorld::LoadGameWorld(EntryPackage.ToString(), EWorldInitFlags::WithBeginPlay);
+		UTEST_TRUE("Load tracker records original world package", ScopedWorld->GetLoadTracker().GetLoadedPackages().Contains(EntryPackage));
+
+		FTestDependencyMap WorldDependencyMap{Filename};
+		WorldDependencyMap.Record(TEXT("Tests.LoadGameWorld"), GetTestSourceFileName(), ScopedWorld->GetLoadTracker(), EntryPackage);
+		const FTestDependencies* Dependencies = WorldDependencyMap.Find(TEXT("Tests.LoadGameWorld"));
+		UTEST_TRUE("Test that loads a world records world package", Dependencies != nullptr && Dependencies->Packages.Contains(EntryPackage));
+		UTEST_TRUE("Dependency closure of world package is recorded", Dependencies->Packages.Includes(FTestDependencyMap::GetDependencyClosure(EntryPackage)));
+		UTEST_FALSE("Instanced world package is not recorded", Algo::AnyOf(Dependencies->Packages, [](const FName Package) { return FPackageName::IsTempPackage(FNameBuilder{Package}); }));
+		UTEST_TRUE("World package change selects the test", WorldDependencyMap.SelectAffectedTests({EntryPackage.ToString()}).Tests.Contains(TEXT("Tests.LoadGameWorld")));
+	}
+
+	{
+		// automation world records under the path test selection enumerates tests by
+		IConsoleVariable* TrackVariable = IConsoleManager::Get().FindConsoleVariable(TEXT("CommonAutomation.TrackTestDependencies"));
+		const bool bWasTracking = TrackVariable->GetBool();
+		TrackVariable->Set(true);
+		ON_SCOPE_EXIT { TrackVariable->Set(bWasTracking); };
+
+		const FName EntryPackage{TEXT("/Engine/Maps/Entry")};
+		FAutomationWorld::LoadGameWorld(EntryPackage.ToString(), EWorldInitFlags::WithBeginPlay).Reset();
+
+		TArray<FAutomationTestInfo> TestInfos;
+		FAutomationTestFramework::Get().GetValidTestNames(TestInfos);
+		const FAutomationTestInfo* TestInfo = TestInfos.FindByPredicate([this](const FAutomationTestInfo& Info) { return Info.GetTestName() == GetTestFullName(); });
+		UTEST_NOT_NULL("Test is enumerated", TestInfo);
+		UTEST_EQUAL("Test path matches enumerated test", FTestDependencyMap::GetTestPath(*this), TestInfo->GetFullTestPath());
+
+		const FTestDependencyMap& SessionMap = FTestDependencyMap::GetSessionMap();
+		const FTestDependencies* Dependencies = SessionMap.Find(TestInfo->GetFullTestPath());
+		UTEST_TRUE("Automation world records dependencies by full test path", Dependencies != nullptr && Dependencies->Packages.Contains(EntryPackage));
+		UTEST_TRUE("World package change selects the test by full test path", SessionMap.SelectAffectedTests({EntryPackage.ToString()}).Tests.Contains(TestInfo->GetFullTestPath()));
+	}
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationLoadManifestTest, "CommonAutomation.LoadManifest", AutomationTestFlags)
+
+bool FAutomationLoadManifestTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
 
+	const FString TestName = GetTestFullName();
+	ON_SCOPE_EXIT { IFileManager::Get().Delete(*FLoadManifest::GetFilename(TestName)); };
+
+	const FName DefaultMaterial{TEXT("/Engine/EngineMaterials/DefaultMaterial")};
+	const FName DeletedPackage{TEXT("/Engine/CommonAutomation/DeletedPackage")};
+	UTEST_TRUE("Manifest is saved", FLoadManifest::Save(TestName, {DefaultMaterial, FName{TEXT("/Temp/World_Test0")}, FName{TEXT("/Script/Engine")}, DeletedPackage}));
+
+	const TArray<FName> Manifest = FLoadManifest::Load(TestName);
+	UTEST_TRUE("Instanced, script and unknown packages are skipped", Manifest.Num() == 1 && Manifest[0] == DefaultMaterial);
+	
+	LoadPackage(nullptr, *DefaultMaterial.ToString(), LOAD_None);
+	UTEST_EQUAL("Loaded packages are not requested", FLoadManifest::Preload(Manifest), 0);
+
+	const FName WorldGridMaterial{TEXT("/Engine/EngineMaterials/WorldGridMaterial")};
+	UTEST_TRUE("Manifest is saved", FLoadManifest::Save(TestName, {WorldGridMaterial}));
+	const TArray<FName> NextManifest = FLoadManifest::Load(TestName);
+	UTEST_TRUE("Manifest is replaced rather than extended", NextManifest.Num() == 1 && NextManifest[0] == WorldGridMaterial);
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_LoadCostTest, "CommonAutomation.AutomationWorld.LoadCost", AutomationTestFlags)
+
+bool FAutomationWorld_LoadCostTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+
+	FLoadBudget Budget;
+	Budget.MaxPackages = 10000;
+	FAutomationWorldPtr ScopedWorld = Init(FWorldInitParams::WithGameInstance).AddLoadBudget(Budget).Create();
+
+	const FPackageLoadTracker& Tracker = ScopedWorld->GetLoadTracker();
+	UTEST_TRUE("Loads after creation are attributed to runtime", Tracker.GetPhase() == ELoadPhase::Runtime);
+
+	const FLoadPhaseStats Stats = ScopedWorld->GetLoadStats();
+	UTEST_EQUAL("Sync and async loads sum up", Stats.NumSyncPackages + Stats.NumAsyncPackages, Stats.NumPackages);
+	UTEST_TRUE("World creation is timed", Stats.WallTimeMs > 0.0);
+	UTEST_TRUE("Heaviest packages are limited", Tracker.GetHeaviestPackages(1).Num() <= 1);
+
+	FLoadBudget TightBudget;
+	TightBudget.Phase = ELoadPhase::MapLoad;
+	TightBudget.MaxWallTimeMs = UE_DOUBLE_SMALL_NUMBER;
+	UTEST_EQUAL("Exceeded budget is reported", Tracker.CheckBudget(TightBudget).Num(), 1);
+
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_SyncLoadDetectorTest, "CommonAutomation.AutomationWorld.SyncLoadDetector", AutomationTestFlags)
+
+bool FAutomationWorld_SyncLoadDetectorTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+
+	FSyncLoadDetector Detector{ESyncLoadPolicy::Warning};
+	FCoreUObjectDelegates::OnSyncLoadPackage.Broadcast(TEXT("/Game/Inactive"));
+	UTEST_TRUE("Loads outside of frames are ignored", Detector.GetSyncLoads().IsEmpty());
+
+	Detector.SetActive(true, 1);
+	for (int32 Index = 0; Index < 2; ++Index)
+	{
+		FCoreUObjectDelegates::OnSyncLoadPackage.Broadcast(TEXT("/Game/Active"));
+	}
+	Detector.SetActive(false);
+	
+	UTEST_EQUAL("Repeated loads are deduplicated", Detector.GetSyncLoads().Num(), 1);
+	UTEST_EQUAL("Repeated loads are counted", Detector.GetSyncLoads()[0].Count, 2);
+	UTEST_TRUE("Report names the package", FSyncLoadDetector::FormatSyncLoad(Detector.GetSyncLoads()[0]).Contains(TEXT("/Game/Active")));
+
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld();
+	ScopedWorld->StartSyncLoadDetection(ESyncLoadPolicy::Error);
+	UTEST_TRUE("Detection doesn't start tick profiling by default", ScopedWorld->GetTickProfiler() == nullptr);
+	ScopedWorld->TickWorld(1);
+	UTEST_TRUE("World without loads doesn't report sync loads", ScopedWorld->GetSyncLoadDetector()->GetSyncLoads().IsEmpty());
+
+	ScopedWorld->StartSyncLoadDetection(ESyncLoadPolicy::Error, true);
+	UTEST_TRUE("Attribution starts tick profiling", ScopedWorld->GetTickProfiler() != nullptr);
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationAssetStubsTest, "CommonAutomation.AssetStubs", AutomationTestFlags)
+
+bool FAutomationAssetStubsTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+
+	const FName MeshPackage{TEXT("/Engine/BasicShapes/Cube")};
+	TArray<FAssetData> Assets;
+	IAssetRegistry::GetChecked().GetAssetsByPackageName(MeshPackage, Assets);
+	UTEST_EQUAL("Mesh asset is found", Assets.Num(), 1);
+
+	UClass* StubClasses[] = {UStaticMesh::StaticClass(), UMaterialInterface::StaticClass()};
+	UTEST_TRUE("Static mesh is stubbed", FAssetStubs(StubClasses, false).ShouldStub(Assets[0]));
+	UTEST_FALSE("Static mesh is kept for collision", FAssetStubs(StubClasses, true).ShouldStub(Assets[0]));
+
+	const FName MaterialPackage{TEXT("/Engine/BasicShapes/BasicShapeMaterial")};
+	TArray<FAssetData> MaterialAssets;
+	IAssetRegistry::GetChecked().GetAssetsByPackageName(MaterialPackage, MaterialAssets);
+	UTEST_EQUAL("Material asset is found", MaterialAssets.Num(), 1);
+	UTEST_TRUE("Material is stubbed even if collision meshes are kept", FAssetStubs(StubClasses, true).ShouldStub(MaterialAssets[0]));
+
+	// mesh material is loaded, stubbing it saves nothing
+	LoadPackage(nullptr, *MaterialPackage.ToString(), LOAD_None);
+	FAssetStubs Stubs{StubClasses, false};
+	FLinkerInstancingContext InstancingContext{};
+	UTEST_EQUAL("Loaded dependencies are not stubbed", Stubs.AddStubs(MeshPackage, InstancingContext), 0);
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_StubAssetsTest, "CommonAutomation.AutomationWorld.StubAssets", AutomationTestFlags)
+
+bool FAutomationWorld_StubAssetsTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+	
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::LoadGameWorld(TEXT("/CommonAutomation/WPUnitTest"), EWorldInitFlags::StartPlay | EWorldInitFlags::InitWorldPartition | EWorldInitFlags::StubAssets);
+	UTEST_TRUE("Automation world is valid", ScopedWorld.IsValid());
+	UTEST_TRUE("World is stubbed", ScopedWorld->GetAssetStubs() != nullptr);
+	UTEST_TRUE("World dependencies are stubbed", ScopedWorld->GetAssetStubs()->Num() > 0);
+
+	for (const FName Package: ScopedWorld->GetAssetStubs()->GetStubbedPackages())
+	{
+		UTEST_TRUE("Stub is loaded instead", FindObjectFast<UPackage>(nullptr, FAssetStubs::GetStubPackageName(Package)) != nullptr);
+		UTEST_TRUE("Stubbed package is not in memory", FindObjectFast<UPackage>(nullptr, Package) == nullptr);
+		UTEST_FALSE("Stubbed package is not loaded by the world", ScopedWorld->GetLoadTracker().GetLoadedPackages().Contains(Package));
+	}
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_ActorFilterTest, "CommonAutomation.AutomationWorld.ActorFilter", AutomationTestFlags)
+
+bool FAutomationWorld_ActorFilterTest::RunTest(const FString& Parameters)
+{
+	{
+		FAutomationWorldPtr ScopedWorld = FAutomationWorld::CreateGameWorld();
+		AStaticMeshActor* Actor = ScopedWorld->SpawnActor<AStaticMeshActor>();
+
+		UTEST_TRUE("No filter loads every actor", FWorldInitParams::Minimal.ShouldLoadActor(Actor));
+		UTEST_FALSE("Excluded class is filtered", Init(FWorldInitParams::Minimal).ExcludeActors<AStaticMeshActor>().ShouldLoadActor(Actor));
+		UTEST_TRUE("Included class is loaded", Init(FWorldInitParams::Minimal).IncludeActors<AStaticMeshActor>().ShouldLoadActor(Actor));
+		UTEST_FALSE("Exclusion takes precedence", Init(FWorldInitParams::Minimal).IncludeActors<AActor>().ExcludeActors<AStaticMeshActor>().ShouldLoadActor(Actor));
+		UTEST_TRUE("World settings are always loaded", Init(FWorldInitParams::Minimal).ExcludeActors<AActor>().ShouldLoadActor(ScopedWorld->GetWorld()->GetWorldSettings()));
+	}
+
+	const FWorldInitParams InitParams = Init(FWorldInitParams::Minimal).SetWorldPackage(TEXT("/Engine/Maps/Entry")).ExcludeActors<AActor>();
+	FAutomationWorldPtr ScopedWorld = InitParams.Create();
+	UTEST_TRUE("Automation world is valid", ScopedWorld.IsValid());
+	for (AActor* Actor: ScopedWorld->GetWorld()->PersistentLevel->Actors)
+	{
+		UTEST_TRUE("Only required actors are loaded", Actor == nullptr || InitParams.ShouldLoadActor(Actor));
+	}
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_DataLayersTest, "CommonAutomation.AutomationWorld.DataLayers", AutomationTestFlags)
+
+bool FAutomationWorld_DataLayersTest::RunTest(const FString& Parameters)
+{
+	AddExpectedError(TEXT("Data layer MissingDataLayer not found"), EAutomationExpectedErrorFlags::Contains, 1);
+
+	FAutomationWorldPtr ScopedWorld = Init(FWorldInitParams::WithBeginPlay)
+	.AddFlags(EWorldInitFlags::InitWorldPartition)
+	.SetWorldPackage(TEXT("/CommonAutomation/WPUnitTest"))
+	.SetDataLayerState(TEXT("MissingDataLayer"), EDataLayerRuntimeState::Activated)
+	.UnloadOtherDataLayers()
+	.Create();
+	UTEST_TRUE("Automation world is valid", ScopedWorld.IsValid());
+
+	UDataLayerManager* DataLayerManager = UDataLayerManager::GetDataLayerManager(ScopedWorld->GetWorld());
+	UTEST_TRUE("Data layer manager is valid", DataLayerManager != nullptr);
+	
+	DataLayerManager->ForEachDataLayerInstance([this, DataLayerManager](UDataLayerInstance* DataLayer)
+	{
+		if (DataLayer->IsRuntime())
+		{
+			TestTrue(TEXT("Other runtime data layers are unloaded"), DataLayerManager->GetDataLayerInstanceRuntimeState(DataLayer) == EDataLayerRuntimeState::Unloaded);
+		}
+		return true;
+	});
+
+#if WITH_EDITOR
+	// test map has no runtime data layers, create one in the loaded world
+	UDataLayerAsset* DataLayerAsset = NewObject<UDataLayerAsset>(GetTransientPackage(), TEXT("AutomationTestDataLayer"), RF_Transient);
+	DataLayerAsset->SetType(EDataLayerType::Runtime);
+	
+	FDataLayerCreationParameters CreationParams;
+	CreationParams.DataLayerAsset = DataLayerAsset;
+	CreationParams.WorldDataLayers = ScopedWorld->GetWorld()->GetWorldDataLayers();
+	UDataLayerInstance* DataLayer = UDataLayerEditorSubsystem::Get()->CreateDataLayerInstance(CreationParams);
+	UTEST_TRUE("Runtime data layer is created", DataLayer != nullptr && DataLayer->IsRuntime());
+
+	const FName DataLayerNames[] = {DataLayerAsset->GetFName(), DataLayer->GetDataLayerFName(), FName{DataLayer->GetDataLayerFullName()}};
+	for (const FName DataLayerName: DataLayerNames)
+	{
+		const FWorldInitParams Params = Init(FWorldInitParams::WithBeginPlay).SetDataLayerState(DataLayerName, EDataLayerRuntimeState::Activated);
+		const EDataLayerRuntimeState* State = Params.FindDataLayerState(DataLayer);
+		UTEST_TRUE(*FString::Printf(TEXT("Data layer is matched by %s"), *DataLayerName.ToString()), State != nullptr && *State == EDataLayerRuntimeState::Activated);
+	}
+	UTEST_TRUE("Other data layer name doesn't match", Init(FWorldInitParams::WithBeginPlay).SetDataLayerState(TEXT("MissingDataLayer"), EDataLayerRuntimeState::Activated).FindDataLayerState(DataLayer) == nullptr);
+#endif
+	
+	return !HasAnyErrors();
+}
+
+#if WITH_EDITOR
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_LoadRegionTest, "CommonAutomation.AutomationWorld.LoadRegion", AutomationTestFlags)
+
+bool FAutomationWorld_LoadRegionTest::RunTest(const FString& Parameters)
+{
+	auto CountLoadedActors = [](const FBox& Region)
+	{
+		FAutomationWorldPtr ScopedWorld = Init(FWorldInitParams{EWorldType::Editor, EWorldInitFlags::None})
+		.SetWorldPackage(TEXT("/CommonAutomation/WPUnitTest"))
+		.AddLoadRegion(Region)
+		.Create();
+		
+		int32 NumActors = 0;
+		for (TActorIterator<AActor> It{ScopedWorld->GetWorld()}; It; ++It)
+		{
+			++NumActors;
+		}
+		return NumActors;
+	};
+
+	const int32 NumRegionActors = CountLoadedActors(FBox{FVector{-UE_LARGE_WORLD_MAX}, FVector{UE_LARGE_WORLD_MAX}});
+	const int32 NumEmptyRegionActors = CountLoadedActors(FBox{FVector{UE_LARGE_WORLD_MAX - 1.0}, FVector{UE_LARGE_WORLD_MAX}});
+	UTEST_TRUE("Actors outside of load region are not loaded", NumEmptyRegionActors < NumRegionActors);
+
+	// exclude a class of spatially loaded actors, they are skipped by descriptors rather than loaded and removed
+	const TArray<UE::Automation::FActorDescInfo> ActorDescs = UE::Automation::FActorDescQuery::Find(TEXT("/CommonAutomation/WPUnitTest"));
+	const UE::Automation::FActorDescInfo* SpatialActor = ActorDescs.FindByPredicate([](const UE::Automation::FActorDescInfo& Info) { return Info.bIsSpatiallyLoaded; });
+	UTEST_TRUE("Map has spatially loaded actors", SpatialActor != nullptr);
+	UClass* ExcludedClass = FindObject<UClass>(SpatialActor->NativeClass);
+	UTEST_TRUE("Actor class is loaded", ExcludedClass != nullptr);
+
+	FAutomationWorldPtr ScopedWorld = Init(FWorldInitParams{EWorldType::Editor, EWorldInitFlags::None})
+	.SetWorldPackage(TEXT("/CommonAutomation/WPUnitTest"))
+	.AddLoadRegion(FBox{FVector{-UE_LARGE_WORLD_MAX}, FVector{UE_LARGE_WORLD_MAX}})
+	.ExcludeActors(ExcludedClass)
+	.Create();
+	UTEST_TRUE("Automation world is valid", ScopedWorld.IsValid());
+	for (TActorIterator<AActor> It{ScopedWorld->GetWorld()}; It; ++It)
+	{
+		UTEST_FALSE("Excluded actor is not loaded", It->IsA(ExcludedClass));
+	}
+	
+	// always loaded actors are loaded with world partition, they can only be removed
+	const int32 NumAlwaysLoaded = Algo::CountIf(ActorDescs, [ExcludedClass](const UE::Automation::FActorDescInfo& Info)
+	{
+		const UClass* NativeClass = FindObject<UClass>(Info.NativeClass);
+		return !Info.bIsSpatiallyLoaded && NativeClass != nullptr && NativeClass->IsChildOf(ExcludedClass);
+	});
+	UTEST_TRUE("Region actors are not loaded and removed", ScopedWorld->GetNumFilteredActors() <= NumAlwaysLoaded);
+	
+	return !HasAnyErrors();
+}
+#endif
+
+#if WITH_EDITOR
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationActorDescQueryTest, "CommonAutomation.ActorDescQuery", AutomationTestFlags)
+
+bool FAutomationActorDescQueryTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+	
+	const FName MapPackage{TEXT("/CommonAutomation/WPUnitTest")};
+	const int32 NumActors = FActorDescQuery::Count(MapPackage);
+	UTEST_TRUE("Actor descriptors are found", NumActors > 0);
+	UTEST_EQUAL("Actor class matches every actor", FActorDescQuery::Count(MapPackage, FActorDescFilter{}.AddClass<AActor>()), NumActors);
+	UTEST_EQUAL("Find returns every matched actor", FActorDescQuery::Find(MapPackage).Num(), NumActors);
+
+	FActorDescFilter FarAwayFilter;
+	FarAwayFilter.Bounds = FBox{FVector{UE_LARGE_WORLD_MAX - 1.0}, FVector{UE_LARGE_WORLD_MAX}};
+	UTEST_TRUE("Bounds filter skips actors outside of bounds", FActorDescQuery::Count(MapPackage, FarAwayFilter) < NumActors);
+
+	int32 NumVisited = 0;
+	FActorDescQuery::ForEach(MapPackage, {}, [&NumVisited](const FActorDescInfo& Info)
+	{
+		++NumVisited;
+		return false;
+	});
+	UTEST_EQUAL("Iteration stops when requested", NumVisited, 1);
+
+	FActorDescInfo DataLayerActor;
+	DataLayerActor.DataLayers = {TEXT("DataLayer_Instance"), TEXT("DL_Asset")};
+	FActorDescFilter DataLayerFilter;
+	DataLayerFilter.DataLayers = {TEXT("DL_Asset")};
+	UTEST_TRUE("Data layer asset name matches", DataLayerFilter.Matches(DataLayerActor, AActor::StaticClass()));
+	DataLayerFilter.DataLayers = {TEXT("DL_Other")};
+	UTEST_FALSE("Other data layer doesn't match", DataLayerFilter.Matches(DataLayerActor, AActor::StaticClass()));
+	
+	return !HasAnyErrors();
+}
+#endif
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorld_PreloadExternalActorDependenciesTest, "CommonAutomation.AutomationWorld.PreloadExternalActorDependencies", AutomationTestFlags)
+
+bool FAutomationWorld_PreloadExternalActorDependenciesTest::RunTest(const FString& Parameters)
+{
+	const FName WorldPackage{TEXT("/CommonAutomation/WPUnitTest")};
+	auto CountLoadedActors = [WorldPackage](EWorldInitFlags InitFlags)
+	{
+		FAutomationWorldPtr ScopedWorld = FAutomationWorld::LoadGameWorld(WorldPackage.ToString(), InitFlags);
+		ScopedWorld->TickWorld(1);
+		
+		int32 NumActors = 0;
+		for (TActorIterator<AActor> It{ScopedWorld->GetWorld()}; It; ++It)
+		{
+			++NumActors;
+		}
+		return NumActors;
+	};
+
+	const EWorldInitFlags InitFlags = EWorldInitFlags::WithBeginPlay | EWorldInitFlags::InitWorldPartition;
+	const EWorldInitFlags PreloadInitFlags = InitFlags | EWorldInitFlags::PreloadExternalActorDependencies;
+	UTEST_EQUAL("Preloading doesn't change loaded actors", CountLoadedActors(PreloadInitFlags), CountLoadedActors(InitFlags));
+
+	const TArray<FName> Dependencies = Init(FWorldInitParams{EWorldType::Game, PreloadInitFlags}).SetWorldPackage(WorldPackage.ToString()).GatherExternalActorDependencies();
+	const TArray<FName> RegionDependencies = Init(FWorldInitParams{EWorldType::Game, PreloadInitFlags}).SetWorldPackage(WorldPackage.ToString())
+		.AddLoadRegion(FBox{FVector{-UE_LARGE_WORLD_MAX}, FVector{UE_LARGE_WORLD_MAX}}).GatherExternalActorDependencies();
+	UTEST_EQUAL("Load regions don't select actors of game worlds", RegionDependencies.Num(), Dependencies.Num());
+
+	// world package instance finishes loading before world partition loads its actors, preloaded dependencies finish before it
+	TSet<FName> LoadedBeforeWorld;
+	for (const FName Dependency: Dependencies)
+	{
+		if (FindObjectFast<UPackage>(nullptr, Dependency) != nullptr)
+		{
+			LoadedBeforeWorld.Add(Dependency);
+		}
+	}
+	
+	bool bWorldLoaded = false;
+	const FDelegateHandle EndLoadHandle = FCoreUObjectDelegates::OnEndLoadPackage.AddLambda([WorldPackage, &LoadedBeforeWorld, &bWorldLoaded](const FEndLoadPackageContext& Context)
+	{
+		for (const UPackage* Package: Context.LoadedPackages)
+		{
+			if (Package == nullptr || bWorldLoaded)
+			{
+				continue;
+			}
+			
+			if (Package->GetLoadedPath().GetPackageFName() == WorldPackage)
+			{
+				bWorldLoaded = true;
+				continue;
+			}
+			LoadedBeforeWorld.Add(Package->GetFName());
+		}
+	});
+	ON_SCOPE_EXIT { FCoreUObjectDelegates::OnEndLoadPackage.Remove(EndLoadHandle); };
+	
+	FAutomationWorldPtr ScopedWorld = FAutomationWorld::LoadGameWorld(WorldPackage.ToString(), PreloadInitFlags);
+	UTEST_TRUE("World package is loaded", bWorldLoaded);
+	for (const FName Dependency: Dependencies)
+	{
+		UTEST_TRUE(*FString::Printf(TEXT("%s is resident before world is loaded"), *Dependency.ToString()), LoadedBeforeWorld.Contains(Dependency));
+	}
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationWorldSweepTest, "CommonAutomation.WorldSweep", AutomationTestFlags)
+
+bool FAutomationWorldSweepTest::RunTest(const FString& Parameters)
+{
+	using namespace UE::Automation;
+
+	FARFilter Filter;
+	Filter.PackagePaths.Add(TEXT("/CommonAutomation"));
+	const TArray<FName> Worlds = FindSweepWorlds(Filter);
+	UTEST_TRUE("Plugin worlds are found", Worlds.Contains(FName{TEXT("/CommonAutomation/WPUnitTest")}));
+
+	// packages loaded since the previous world package, by the world package they were loaded before
+	TMap<FName, TSet<FName>> LoadedBeforeWorld;
+	TSet<FName> LoadedPackages;
+	const FDelegateHandle EndLoadHandle = FCoreUObjectDelegates::OnEndLoadPackage.AddLambda([&Worlds, &LoadedBeforeWorld, &LoadedPackages](const FEndLoadPackageContext& Context)
+	{
+		for (const UPackage* Package: Context.LoadedPackages)
+		{
+			if (Package == nullptr)
+			{
+				continue;
+			}
+			
+			const FName LoadedPath = Package->GetLoadedPath().GetPackageFName();
+			if (Worlds.Contains(LoadedPath))
+			{
+				LoadedBeforeWorld.FindOrAdd(LoadedPath).Append(MoveTemp(LoadedPackages));
+				LoadedPackages.Reset();
+				continue;
+			}
+			LoadedPackages.Add(Package->GetFName());
+		}
+	});
+	ON_SCOPE_EXIT { FCoreUObjectDelegates::OnEndLoadPackage.Remove(EndLoadHandle); };
+
+	TArray<FName> SweptWorlds;
+	const TArray<FWorldSweepEntry> Entries = SweepWorlds(Filter, [&SweptWorlds](FAutomationWorld& AutomationWorld)
+	{
+		SweptWorlds.Add(AutomationWorld.GetWorld()->GetPackage()->GetFName());
+		AutomationWorld.TickWorld(2);
+	});
+	
+	UTEST_EQUAL("Every world is swept", Entries.Num(), Worlds.Num());
+	UTEST_EQUAL("Callback is called for every world", SweptWorlds.Num(), Worlds.Num());
+	UTEST_TRUE("Worlds are loaded", Algo::AllOf(Entries, [](const FWorldSweepEntry& Entry) { return Entry.bLoaded && Entry.LoadTimeMs > 0.0; }));
+	UTEST_TRUE("Garbage is collected after every world without memory cap", Algo::AllOf(Entries, [](const FWorldSweepEntry& Entry) { return Entry.bCollectedGarbage; }));
+	UTEST_TRUE("First world has nothing prefetched", Entries[0].PrefetchedPackages.IsEmpty());
+	UTEST_FALSE("World doesn't outlive the sweep", FAutomationWorld::Exists());
+
+	for (const FWorldSweepEntry& Entry: Entries)
+	{
+		const TSet<FName>* Loaded = LoadedBeforeWorld.Find(Entry.WorldPackage);
+		for (const FName Package: Entry.PrefetchedPackages)
+		{
+			UTEST_TRUE(*FString::Printf(TEXT("%s is prefetched before %s is created"), *Package.ToString(), *Entry.WorldPackage.ToString()), Loaded != nullptr && Loaded->Contains(Package));
+		}
+	}
+
+	{
+		FWorldSweepOptions Options;
+		Options.MemoryCapMB = MAX_uint64 / 2;
+		const TArray<FWorldSweepEntry> CappedEntries = SweepWorlds(Filter, [](FAutomationWorld&) {}, Options);
+		UTEST_EQUAL("Every world is swept with memory cap", CappedEntries.Num(), Worlds.Num());
+		UTEST_TRUE("Garbage is not collected below memory cap", Algo::NoneOf(CappedEntries, [](const FWorldSweepEntry& Entry) { return Entry.bCollectedGarbage; }));
+	}
+
+	{
+		FWorldSweepOptions Options;
+		Options.MemoryCapMB = 1;
+		const TArray<FWorldSweepEntry> CappedEntries = SweepWorlds(Filter, [](FAutomationWorld&) {}, Options);
+		UTEST_TRUE("Garbage is collected above memory cap", Algo::AllOf(CappedEntries, [](const FWorldSweepEntry& Entry) { return Entry.bCollectedGarbage; }));
+	}
+
+	// garbage of the uncollected sweep
+	CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	
+	return !HasAnyErrors();
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAutomationForkServerWorkerExitTest, "CommonAutomation.ForkServer.WorkerExit", AutomationTestFlags)
+
+bool FAutomationForkServerWorkerExitTest::RunTest(const FString& Parameters)
+{
+	using FCommandlet = UCommonAutomationForkServerCommandlet;
+	
+	auto Receive = [](FCommandlet::FWorkerTests& Worker, const FString& Output)
+	{
+		const FTCHARToUTF8 Converted{*Output};
+		Worker.Buffer.Append(Converted.Get(), Converted.Length());
+	};
+
+	{
+		FCommandlet::FWorkerTests Worker;
+		Worker.Tests = {TEXT("A"), TEXT("B")};
+		TMap<FString, FCommandlet::FTestResult> Results;
+		
+		UTEST_TRUE("Worker that didn't start a test fails to start", FCommandlet::HandleWorkerExit(Worker, false, Results) == FCommandlet::EWorkerExit::StartupFailed);
+		UTEST_TRUE("No test is blamed for startup failure", Results.IsEmpty());
+		UTEST_EQUAL("Tests are kept for replacement worker", Worker.Tests.Num(), 2);
+	}
+
+	{
+		FCommandlet::FWorkerTests Worker;
+		Worker.Tests = {TEXT("A"), TEXT("B"), TEXT("C")};
+		TMap<FString, FCommandlet::FTestResult> Results;
+		
+		// partial line is kept until the rest of it is received
+		Receive(Worker, TEXT("S\tA\nR\t1\t0\tA\nS\tB"));
+		FCommandlet::ProcessOutput(Worker, Results);
+		Receive(Worker, TEXT("\n"));
+		FCommandlet::ProcessOutput(Worker, Results);
+		UTEST_EQUAL("Started tests are counted", Worker.NumStarted, 2);
+		UTEST_EQUAL("Completed tests are counted", Worker.NumCompleted, 1);
+
+		AddExpectedError(TEXT("worker crashed while running B"), EAutomationExpectedErrorFlags::Contains, 1);
+		UTEST_TRUE("Worker crashed", FCommandlet::HandleWorkerExit(Worker, false, Results) == FCommandlet::EWorkerExit::Crashed);
+		UTEST_TRUE("Finished test keeps its result", Results.Contains(TEXT("A")) && Results[TEXT("A")].bSuccess && !Results[TEXT("A")].bCrashed);
+		UTEST_TRUE("Running test is blamed", Results.Contains(TEXT("B")) && Results[TEXT("B")].bCrashed);
+		UTEST_TRUE("Replacement worker continues with remaining tests", Worker.Tests == TArray<FString>{TEXT("C")});
+	}
+
+	{
+		FCommandlet::FWorkerTests Worker;
+		Worker.Tests = {TEXT("A")};
+		TMap<FString, FCommandlet::FTestResult> Results;
+		
+		Receive(Worker, TEXT("S\tA\nR\t0\t2\tA\n"));
+		FCommandlet::ProcessOutput(Worker, Results);
+		UTEST_TRUE("Worker completed", FCommandlet::HandleWorkerExit(Worker, true, Results) == FCommandlet::EWorkerExit::Completed);
+		UTEST_TRUE("Failed test is reported", Results.Contains(TEXT("A")) && !Results[TEXT("A")].bSuccess && Results[TEXT("A")].NumErrors == 2);
+	}
+	
 	return !HasAnyErrors();
 }
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/TopLevelAssetPath.h"
+
+namespace UE::Automation
+{
+
+/** Actor metadata read from world partition actor descriptor */
+struct COMMONAUTOMATION_API FActorDescInfo
+{
+	FGuid Guid;
+	/** first native class of the actor */
+	FTopLevelAssetPath NativeClass;
+	/** blueprint class of the actor, or native class for native actors */
+	FTopLevelAssetPath BaseClass;
+	FName Label;
+	FName ActorPackage;
+	FSoftObjectPath ActorPath;
+	FBox Bounds{ForceInit};
+	bool bIsSpatiallyLoaded = false;
+	/** data layer instance names and data layer asset names, either identifies data layer in FAutomationWorldInitParams::SetDataLayerState */
+	TArray<FName> DataLayers;
+	TArray<FName> Tags;
+};
+
+/** Actor descriptor filter. Empty criteria match every actor */
+struct COMMONAUTOMATION_API FActorDescFilter
+{
+	/** match actors of any of these native classes, including derived classes */
+	TArray<UClass*> Classes;
+	/** match actors with bounds intersecting @Bounds */
+	TOptional<FBox> Bounds;
+	/** match actors in any of these data layers, by data layer instance or asset name, same as FAutomationWorldInitParams::SetDataLayerState */
+	TArray<FName> DataLayers;
+	/** match actors with any of these tags */
+	TArray<FName> Tags;
+	/** match actors whose label contains @Label */
+	FString Label;
+
+	template <typename T>
+	FActorDescFilter& AddClass()
+	{
+		Classes.AddUnique(T::StaticClass());
+		return *this;
+	}
+
+	bool Matches(const FActorDescInfo& ActorDesc, const UClass* NativeClass) const;
+};
+
+/**
+ * Queries actor descriptors of world partition maps without loading the map or instantiating actors.
+ * Descriptors are read from asset registry tags of external actor packages, only one descriptor is alive at a time.
+ * Actor descriptors are editor data, queries return nothing in non-editor builds
+ */
+class COMMONAUTOMATION_API FActorDescQuery
+{
+public:
+	/**
+	 * call @Func for every actor of @MapPackage that passes @Filter, until @Func returns false
+	 * @return number of matched actors
+	 */
+	static int32 ForEach(FName MapPackage, const FActorDescFilter& Filter, TFunctionRef<bool(const FActorDescInfo&)> Func);
+	/** @return all actors of @MapPackage that pass @Filter */
+	static TArray<FActorDescInfo> Find(FName MapPackage, const FActorDescFilter& Filter = {});
+	/** @return number of actors of @MapPackage that pass @Filter */
+	static int32 Count(FName MapPackage, const FActorDescFilter& Filter = {});
+};
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
+
+struct FAssetData;
+struct FLinkerInstancingContext;
+
+namespace UE::Automation
+{
+
+/**
+ * Substitutes heavy asset dependencies of a loaded world (meshes, textures, materials, sounds, FX) with empty stubs.
+ * Stub is a transient object of the same class and name, created in its own /Temp package. Instancing context maps
+ * original package to the stub package, so that loader resolves imports of the world package to an already existing stub.
+ * Package mapping applies only to packages loaded with the instancing context, so only direct dependencies of the world package
+ * that no other package of the world imports are stubbed. Assets loaded by other packages, by soft references or from code are loaded as usual.
+ * Stubs are intended for logic tests: they have no render data, no collision and no sound data.
+ * Render scene skips primitives without render data and falls back to default material for materials that aren't compiled.
+ */
+class COMMONAUTOMATION_API FAssetStubs
+{
+public:
+	/**
+	 * @InStubClasses asset classes replaced with stubs, including derived classes
+	 * @bInKeepCollisionMeshes keep static meshes, required for worlds that trace against or simulate mesh collision
+	 */
+	FAssetStubs(TConstArrayView<UClass*> InStubClasses, bool bInKeepCollisionMeshes);
+
+	FAssetStubs(const FAssetStubs& Other) = delete;
+	FAssetStubs& operator=(const FAssetStubs& Other) = delete;
+
+	/**
+	 * create stubs for direct hard dependencies of @PackageName that should be substituted, aren't loaded yet and aren't imported
+	 * by any other package @PackageName depends on, and add package mapping to @InstancingContext
+	 * @return number of substituted packages
+	 */
+	int32 AddStubs(FName PackageName, FLinkerInstancingContext& InstancingContext);
+
+	/** @return whether asset should be replaced with a stub */
+	bool ShouldStub(const FAssetData& AssetData) const;
+
+	/** @return original names of packages replaced with stubs */
+	FORCEINLINE TConstArrayView<FName> GetStubbedPackages() const { return StubbedPackages; }
+	FORCEINLINE int32 Num() const { return StubbedPackages.Num(); }
+
+	/** @return name of a stub package for @PackageName */
+	static FName GetStubPackageName(FName PackageName);
+	/** @return default list of substituted classes, resolved from CommonAutomationSettings */
+	static TArray<UClass*> GetDefaultStubClasses();
+
+private:
+	/** @return stub package for an asset, creating it if necessary */
+	UPackage* CreateStub(const FAssetData& AssetData, UClass* AssetClass);
+
+	TArray<UClass*> StubClasses;
+	bool bKeepCollisionMeshes = false;
+
+	TArray<FName> StubbedPackages;
+	/** keep stubs alive while world is loaded and used */
+	TArray<TStrongObjectPtr<UPackage>> StubPackages;
+};
+
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AutomationWorld.h"
+#include "Misc/AutomationTest.h"
+
+namespace UE::Automation
+{
+
+/** Statistics for a set of benchmark samples, computed after outlier rejection */
+struct COMMONAUTOMATION_API FBenchmarkStats
+{
+	double Min = 0.0;
+	double Max = 0.0;
+	double Median = 0.0;
+	double P95 = 0.0;
+	double Mean = 0.0;
+	double StdDev = 0.0;
+	/** number of samples used to compute statistics */
+	int32 NumSamples = 0;
+	/** number of samples rejected as outliers */
+	int32 NumOutliers = 0;
+};
+
+/**
+ * @return statistics for @Samples.
+ * Samples further than @OutlierThreshold scaled median absolute deviations from the median are rejected. Zero or negative threshold disables rejection
+ */
+COMMONAUTOMATION_API FBenchmarkStats ComputeBenchmarkStats(TConstArrayView<double> Samples, double OutlierThreshold);
+
+}
+
+/** Benchmark configuration, filled from FAutomationBenchmarkBase::Define */
+struct COMMONAUTOMATION_API FAutomationBenchmarkConfig
+{
+	/** init params for the world benchmark body runs against. World is created once per sweep parameter */
+	TOptional<FAutomationWorldInitParams> WorldParams;
+	/** number of untimed iterations before measurement */
+	int32 NumWarmup = 3;
+	/** number of timed iterations */
+	int32 NumRepetitions = 20;
+	/** outlier rejection threshold, in scaled median absolute deviations */
+	double OutlierThreshold = 3.0;
+	/** parameter sweep, every parameter is executed as a separate test */
+	TArray<FString> SweepParams;
+
+	/** benchmark body, timed */
+	TFunction<void(FAutomationWorld&, const FString&)> Body;
+	/** invoked before every iteration, not timed */
+	TFunction<void(FAutomationWorld&, const FString&)> BeforeIteration;
+	/** invoked after every iteration, not timed */
+	TFunction<void(FAutomationWorld&, const FString&)> AfterIteration;
+};
+
+/**
+ * Base class for benchmark tests, use BEGIN_AUTOMATION_BENCHMARK/END_AUTOMATION_BENCHMARK macro family to define one:
+ *
+ *	BEGIN_AUTOMATION_BENCHMARK(FSpawnBenchmark, "Project.Benchmark.Spawn", AutomationTestFlags)
+ *	END_AUTOMATION_BENCHMARK(FSpawnBenchmark)
+ *
+ *	void FSpawnBenchmark::Define()
+ *	{
+ *		Config.WorldParams.Emplace(FWorldInitParams::WithBeginPlay);
+ *		Config.NumRepetitions = 50;
+ *		Config.SweepParams = {TEXT("10"), TEXT("100"), TEXT("1000")};
+ *		Config.Body = [](FAutomationWorld& World, const FString& Param)
+ *		{
+ *			for (int32 Index = 0; Index < FCString::Atoi(*Param); ++Index) { World.SpawnActor(); }
+ *		};
+ *	}
+ *
+ * Results (min/median/p95/stddev of wall time) are reported as test telemetry,
+ * written as json artifacts to Saved/Automation/Benchmarks and added to test results as analytics items
+ */
+class COMMONAUTOMATION_API FAutomationBenchmarkBase: public FAutomationTestBase
+{
+public:
+	FAutomationBenchmarkBase(const FString& InName, const bool bInComplexTask)
+		: FAutomationTestBase(InName, bInComplexTask)
+	{}
+
+	virtual uint32 GetRequiredDeviceNum() const override { return 1; }
+	virtual bool IsStressTest() const { return false; }
+
+protected:
+	
+	/** fill benchmark config */
+	virtual void Define() = 0;
+
+	virtual void GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const override;
+	virtual bool RunTest(const FString& Parameters) override;
+
+	/** report benchmark results as telemetry and write json artifact, artifact is attached to test results as an analytics item */
+	void ReportResults(const FString& Parameter, const UE::Automation::FBenchmarkStats& WallTime);
+
+	/** @return json artifact location for a sweep @Parameter */
+	FString GetArtifactPath(const FString& Parameter) const;
+	
+	FAutomationBenchmarkConfig Config;
+	
+private:
+	void EnsureDefined() const;
+	
+	mutable bool bDefined = false;
+};
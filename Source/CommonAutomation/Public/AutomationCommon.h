@@ -7,6 +7,7 @@
 
 struct FAssetData;
 class AAutomationTargetPoint;
+class UActorComponent;
 
 /**
  * Base struct for automation test custom data
@@ -32,6 +33,32 @@ namespace UE::Automation
 		return Component;
 	}
 
+	/** register components in a batch, with render state creation and navigation octree updates processed once for all of them */
+	COMMONAUTOMATION_API void RegisterActorComponents(UWorld* World, TConstArrayView<UActorComponent*> Components);
+	
+	/** @return newly created and registered actor components, one for each actor in @OwnerActors. Components are registered in a batch */
+	template <typename TComponentType>
+	TArray<TComponentType*> CreateActorComponents(UWorld* World, TConstArrayView<AActor*> OwnerActors, UClass* ComponentClass = TComponentType::StaticClass())
+	{
+		check(World != nullptr && ComponentClass != nullptr);
+		
+		TArray<TComponentType*> Components;
+		TArray<UActorComponent*> ComponentsToRegister;
+		Components.Reserve(OwnerActors.Num());
+		ComponentsToRegister.Reserve(OwnerActors.Num());
+		
+		for (AActor* OwnerActor: OwnerActors)
+		{
+			check(OwnerActor != nullptr);
+			TComponentType* Component = NewObject<TComponentType>(OwnerActor, ComponentClass);
+			Components.Add(Component);
+			ComponentsToRegister.Add(Component);
+		}
+
+		RegisterActorComponents(World, ComponentsToRegister);
+		return Components;
+	}
+
 	/** create and register actor component for @OwnerActor */
 	template <typename TComponentType>
 	void AddActorComponent(UWorld* World, AActor* OwnerActor, UClass* ComponentClass = TComponentType::StaticClass(), FName Name = NAME_None)
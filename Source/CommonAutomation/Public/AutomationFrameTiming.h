@@ -0,0 +1,126 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AutomationTickProfiler.h"
+#include "Engine/EngineBaseTypes.h"
+
+class UWorld;
+
+namespace UE::Automation
+{
+
+/** Timings for a single frame ticked by automation world */
+struct FFrameTiming
+{
+	/** automation world frame index */
+	uint64 Frame = 0;
+	/** total frame time, including world tick, tickable objects and level streaming update */
+	double GameThreadMs = 0.0;
+	/** UWorld::Tick time */
+	double WorldTickMs = 0.0;
+	/** tickable objects and core ticker time */
+	double TickablesMs = 0.0;
+	/** garbage collection time during the frame */
+	double GarbageCollectionMs = 0.0;
+};
+
+enum class EFrameTimingStat: uint8
+{
+	GameThread,
+	WorldTick,
+	Tickables,
+	GarbageCollection,
+};
+
+/** Frame that exceeded hitch threshold */
+struct FFrameHitch
+{
+	FFrameTiming Timing;
+	/** tick group that took the most time during the frame, TG_MAX if tick groups were not timed */
+	TEnumAsByte<ETickingGroup> SlowestTickGroup = TG_MAX;
+	/** time spent in each tick group, indexed by ETickingGroup */
+	TArray<double> TickGroupTimesMs;
+	/** slowest tick functions executed during the frame. Captured only if tick profiling is active */
+	TArray<FTickProfileEntry> TickFunctions;
+};
+
+/**
+ * Records per-frame timings of automation world into a ring buffer and detects hitches.
+ * While hitch detection is enabled, high priority sentinel tick functions are registered at the start of every tick group
+ * to time tick groups. If tick profiler is active, hitches also list the slowest tick functions of the frame.
+ */
+class COMMONAUTOMATION_API FFrameTimingRecorder
+{
+public:
+	explicit FFrameTimingRecorder(int32 InCapacity);
+	~FFrameTimingRecorder();
+
+	FFrameTimingRecorder(const FFrameTimingRecorder& Other) = delete;
+	FFrameTimingRecorder& operator=(const FFrameTimingRecorder& Other) = delete;
+
+	/** start recording a frame for @InWorld. Called by automation world before world tick */
+	void BeginFrame(UWorld* InWorld);
+	/** finish recording a frame. @WorldTickEndCycles marks the end of the last tick group */
+	void EndFrame(const FFrameTiming& InTiming, uint64 WorldTickEndCycles, const FTickProfiler* TickProfiler);
+	/** unregister tick group sentinels, e.g. before world travel */
+	void UnregisterSentinels();
+
+	/** record a hitch for every frame that takes longer than @InThresholdMs. Zero or negative value disables hitch detection */
+	void SetHitchThreshold(double InThresholdMs);
+	FORCEINLINE double GetHitchThreshold() const { return HitchThresholdMs; }
+	/** set number of tick functions captured for a hitch */
+	FORCEINLINE void SetNumHitchTickFunctions(int32 InNum) { NumHitchTickFunctions = InNum; }
+
+	/** clear recorded frames and hitches */
+	void Reset();
+
+	/** @return number of recorded frames, up to buffer capacity */
+	FORCEINLINE int32 Num() const { return Frames.Num(); }
+	FORCEINLINE int32 GetCapacity() const { return Capacity; }
+	/** @return recorded frame by index, zero being the oldest frame in the buffer */
+	const FFrameTiming& GetFrame(int32 Index) const;
+	/** @return last recorded frame, or nullptr if no frames were recorded */
+	const FFrameTiming* GetLastFrame() const;
+	/** @return @Percentile (in [0, 1] range) of @Stat over recorded frames, nearest rank */
+	double GetPercentile(EFrameTimingStat Stat, double Percentile) const;
+	/** @return max value of @Stat over recorded frames */
+	double GetMax(EFrameTimingStat Stat) const;
+	/** @return garbage collection time since recorder was created, including GC outside of ticked frames */
+	FORCEINLINE double GetTotalGarbageCollectionMs() const { return FPlatformTime::ToMilliseconds64(TotalGarbageCollectionCycles); }
+	/** @return hitches recorded since the last reset */
+	FORCEINLINE const TArray<FFrameHitch>& GetHitches() const { return Hitches; }
+
+	static double GetStat(const FFrameTiming& Timing, EFrameTimingStat Stat);
+
+private:
+	struct FTickGroupSentinel;
+
+	void RegisterSentinels(UWorld* InWorld);
+	void HandlePreGarbageCollect();
+	void HandlePostGarbageCollect();
+
+	/** frame ring buffer */
+	TArray<FFrameTiming> Frames;
+	/** index of the next frame to write once buffer is full */
+	int32 Head = 0;
+	int32 Capacity = 0;
+
+	TArray<FFrameHitch> Hitches;
+	double HitchThresholdMs = 0.0;
+	int32 NumHitchTickFunctions = 5;
+
+	/** tick group sentinels, registered while hitch detection is enabled */
+	TArray<TUniquePtr<FTickGroupSentinel>> Sentinels;
+	UWorld* SentinelWorld = nullptr;
+	/** cycles at which tick groups started during current frame, zero if tick group didn't run */
+	uint64 TickGroupStartCycles[TG_MAX];
+
+	/** garbage collection time accumulated during current frame */
+	uint64 GarbageCollectionCycles = 0;
+	uint64 GarbageCollectionStartCycles = 0;
+	uint64 TotalGarbageCollectionCycles = 0;
+	FDelegateHandle PreGarbageCollectHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+};
+
+}
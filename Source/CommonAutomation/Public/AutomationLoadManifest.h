@@ -0,0 +1,35 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::Automation
+{
+
+/**
+ * Per-test list of packages loaded while automation world was created, stored as text files under Saved/Automation/LoadManifests.
+ * On the next run manifest packages are requested as async loads and flushed together before world is created,
+ * so that world creation finds its dependencies already loaded instead of loading them one by one.
+ */
+class COMMONAUTOMATION_API FLoadManifest
+{
+public:
+	/** @return manifest packages for @TestName, empty if manifest doesn't exist */
+	static TArray<FName> Load(const FString& TestName);
+	/** write @Packages as manifest of @TestName, replacing the previous one. Packages that can't be preloaded are skipped */
+	static bool Save(const FString& TestName, TConstArrayView<FName> Packages);
+	/**
+	 * @return false for packages that are not loaded from disk by their own name, like instanced world packages,
+	 * and for packages asset registry no longer knows, so that deleted and renamed packages drop out of manifests
+	 */
+	static bool CanPreload(FName Package);
+
+	/**
+	 * request async load for every package that isn't loaded yet and wait for all of them
+	 * @return number of requested packages
+	 */
+	static int32 Preload(TConstArrayView<FName> Packages);
+
+	static FString GetFilename(const FString& TestName);
+};
+
+}
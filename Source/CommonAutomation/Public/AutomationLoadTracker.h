@@ -0,0 +1,128 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/TopLevelAssetPath.h"
+#include "UObject/UObjectArray.h"
+
+struct FEndLoadPackageContext;
+
+namespace UE::Automation
+{
+
+/** Automation world lifetime phase packages are attributed to */
+enum class ELoadPhase: uint8
+{
+	MapLoad,		// world package load or creation and world initialization
+	GameMode,		// game instance, game mode and game state classes
+	BeginPlay,		// BeginPlay and primary player creation
+	Runtime,		// everything after world is created, e.g. ticks and travel
+	Num
+};
+
+COMMONAUTOMATION_API const TCHAR* LexToString(ELoadPhase Phase);
+
+/** Single loaded package */
+struct FPackageLoadCost
+{
+	FName PackageName;
+	/** package file size, zero if linker didn't report it */
+	int64 Bytes = 0;
+	ELoadPhase Phase = ELoadPhase::Runtime;
+	/** whether package was loaded by a synchronous load request */
+	bool bSynchronous = false;
+};
+
+/** Load cost accumulated during a phase */
+struct FLoadPhaseStats
+{
+	int32 NumPackages = 0;
+	int32 NumSyncPackages = 0;
+	int32 NumAsyncPackages = 0;
+	int64 NumBytes = 0;
+	/** wall time of the phase, including everything that isn't loading */
+	double WallTimeMs = 0.0;
+
+	FLoadPhaseStats& operator+=(const FLoadPhaseStats& Other);
+};
+
+/** Load budget checked by automation world, zero values are not checked */
+struct FLoadBudget
+{
+	/** phase to check, unset means all world creation phases */
+	TOptional<ELoadPhase> Phase;
+	int32 MaxPackages = 0;
+	int32 MaxSyncPackages = 0;
+	int64 MaxBytes = 0;
+	double MaxWallTimeMs = 0.0;
+};
+
+/**
+ * Records packages loaded and, optionally, classes of objects instantiated while tracker is alive.
+ * Automation world creates a tracker before its world package is loaded and keeps it for the world lifetime.
+ * Loaded packages are attributed to the current load phase, set by automation world as initialization progresses.
+ * Instanced packages are recorded by the package they were loaded from, e.g. the world package rather than its /Temp instance.
+ * Class tracking listens to every UObject creation, so it is enabled only when requested.
+ */
+class COMMONAUTOMATION_API FPackageLoadTracker: public FUObjectArray::FUObjectCreateListener
+{
+public:
+	explicit FPackageLoadTracker(bool bInTrackClasses);
+	virtual ~FPackageLoadTracker() override;
+
+	FPackageLoadTracker(const FPackageLoadTracker& Other) = delete;
+	FPackageLoadTracker& operator=(const FPackageLoadTracker& Other) = delete;
+
+	/** stop listening to load and object creation events. Recorded data is kept */
+	void Stop();
+
+	/** attribute further loads to @Phase. @return previous phase */
+	ELoadPhase SetPhase(ELoadPhase Phase);
+	FORCEINLINE ELoadPhase GetPhase() const { return CurrentPhase; }
+	
+	/** @return packages loaded since tracker was created, in load order */
+	FORCEINLINE const TArray<FName>& GetLoadedPackages() const { return LoadedPackages; }
+	/** @return load cost of every package loaded since tracker was created, in load order */
+	FORCEINLINE const TArray<FPackageLoadCost>& GetPackageCosts() const { return PackageCosts; }
+	/** @return load stats of @Phase, or of all world creation phases if @Phase is unset */
+	FLoadPhaseStats GetPhaseStats(TOptional<ELoadPhase> Phase = {}) const;
+	/** @return up to @Num largest packages loaded during @Phase, or during all world creation phases if @Phase is unset */
+	TArray<FPackageLoadCost> GetHeaviestPackages(int32 Num, TOptional<ELoadPhase> Phase = {}) const;
+	/** @return budget violations, empty if @Budget is met */
+	TArray<FString> CheckBudget(const FLoadBudget& Budget) const;
+	
+	/** @return classes of objects instantiated since tracker was created */
+	TArray<FTopLevelAssetPath> GetInstantiatedClasses() const;
+	/** @return modules of instantiated native classes */
+	TArray<FName> GetTouchedModules() const;
+	FORCEINLINE bool IsTrackingClasses() const { return bTrackClasses; }
+
+	//~Begin FUObjectCreateListener interface
+	virtual void NotifyUObjectCreated(const UObjectBase* Object, int32 Index) override;
+	virtual void OnUObjectArrayShutdown() override;
+	//~End FUObjectCreateListener interface
+
+private:
+	void HandleEndLoadPackage(const FEndLoadPackageContext& Context);
+	static bool IsCreationPhase(ELoadPhase Phase) { return Phase != ELoadPhase::Runtime; }
+
+	TArray<FName> LoadedPackages;
+	TSet<FName> LoadedPackageSet;
+	TArray<FPackageLoadCost> PackageCosts;
+
+	/** stats of each phase, wall time of the current phase is added on query */
+	FLoadPhaseStats PhaseStats[static_cast<int32>(ELoadPhase::Num)];
+	ELoadPhase CurrentPhase = ELoadPhase::MapLoad;
+	double PhaseStartTime = 0.0;
+
+	/** objects are created on async loading thread as well */
+	mutable FCriticalSection ClassLock;
+	TSet<FTopLevelAssetPath> Classes;
+	/** last recorded class, objects are often created in batches of the same class */
+	const UClass* LastClass = nullptr;
+
+	FDelegateHandle EndLoadPackageHandle;
+	bool bTrackClasses = false;
+	bool bListening = false;
+};
+
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::Automation
+{
+
+/** Performance metrics recorded for a single automation world */
+struct COMMONAUTOMATION_API FPerfHistoryEntry
+{
+	/** full name of the test automation world was created for */
+	FString TestName;
+	/** build changelist, @see FPerfHistory::GetBuildChangelist */
+	uint32 Changelist = 0;
+	/** build version string, @see FApp::GetBuildVersion */
+	FString BuildVersion;
+	FDateTime Timestamp;
+
+	/** time spent in FAutomationWorld::CreateWorld */
+	double WorldCreationMs = 0.0;
+	/** game thread frame time percentiles */
+	double TickP50Ms = 0.0;
+	double TickP95Ms = 0.0;
+	double TickP99Ms = 0.0;
+	/** peak used physical memory sampled during world lifetime, relative to used physical memory before world creation */
+	uint64 PeakUsedMemoryDelta = 0;
+	/** number of packages loaded by the world, from world creation to destruction */
+	int32 PackagesLoaded = 0;
+	/** garbage collection time during world lifetime */
+	double GarbageCollectionMs = 0.0;
+
+	friend FArchive& operator<<(FArchive& Ar, FPerfHistoryEntry& Entry);
+};
+
+enum class EPerfMetric: uint8
+{
+	WorldCreation,
+	TickP50,
+	TickP95,
+	TickP99,
+	PeakMemory,
+	PackagesLoaded,
+	GarbageCollection,
+	Num
+};
+
+/** Metric that regressed against test history */
+struct FPerfRegression
+{
+	EPerfMetric Metric = EPerfMetric::Num;
+	double Value = 0.0;
+	double HistoryMean = 0.0;
+	double HistoryStdDev = 0.0;
+	/** number of standard deviations value is above history mean */
+	double ZScore = 0.0;
+};
+
+/**
+ * Local performance history, stored as an append-only binary file under Saved/Automation.
+ * Every record is size prefixed, so records of unknown version are skipped on load. Files with a truncated header are rejected,
+ * a truncated last record is ignored.
+ */
+class COMMONAUTOMATION_API FPerfHistory
+{
+public:
+	explicit FPerfHistory(const FString& InFilename = GetDefaultFilename());
+
+	/** load history file, @return false if file exists but can't be read */
+	bool Load();
+	/** append @Entry to history file and loaded history */
+	bool Append(const FPerfHistoryEntry& Entry);
+
+	FORCEINLINE const TArray<FPerfHistoryEntry>& GetEntries() const { return Entries; }
+	/** @return up to @MaxEntries most recent entries for @TestName, oldest first */
+	TArray<const FPerfHistoryEntry*> GetTestHistory(const FString& TestName, int32 MaxEntries) const;
+
+	/**
+	 * @return metrics of @Entry that are more than @ZThreshold standard deviations and more than @MinRelativeIncrease above @History mean
+	 * Increase should also exceed metric's absolute minimum, @see GetMinIncrease. Requires at least @MinHistory entries, otherwise regressions are not reported
+	 */
+	static TArray<FPerfRegression> FindRegressions(const FPerfHistoryEntry& Entry, TConstArrayView<const FPerfHistoryEntry*> History,
+		double ZThreshold = 3.0, double MinRelativeIncrease = 0.1, int32 MinHistory = 5);
+
+	static double GetMetric(const FPerfHistoryEntry& Entry, EPerfMetric Metric);
+	/** @return smallest increase over history mean reported as a regression, so that metrics with constant history don't regress on noise */
+	static double GetMinIncrease(EPerfMetric Metric);
+	static const TCHAR* GetMetricName(EPerfMetric Metric);
+	static FString GetDefaultFilename();
+	/**
+	 * @return changelist of the build under test, zero if unknown.
+	 * Read from -AutomationChangelist= command line, uebp_CL environment variable set by AutomationTool or CL-<number> part of the build version
+	 */
+	static uint32 GetBuildChangelist();
+
+private:
+	FString Filename;
+	TArray<FPerfHistoryEntry> Entries;
+};
+
+}
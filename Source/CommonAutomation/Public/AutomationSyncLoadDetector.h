@@ -0,0 +1,68 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::Automation
+{
+
+class FTickProfiler;
+
+enum class ESyncLoadPolicy: uint8
+{
+	Warning,	// report synchronous loads as test warnings
+	Error,		// report synchronous loads as test errors
+};
+
+/** Synchronous load, deduplicated by package, requester and callstack */
+struct FSyncLoad
+{
+	FString PackageName;
+	/** ticking actor or component that requested the load, empty if unknown */
+	FString Requester;
+	/** automation world frame of the first occurrence */
+	uint64 Frame = 0;
+	/** number of occurrences */
+	int32 Count = 0;
+	/** program counters of the first occurrence */
+	TArray<uint64> Callstack;
+};
+
+/**
+ * Records blocking package loads made while automation world ticks frames.
+ * Async loads, including FStreamableManager requests, are allowed. Blocking loads are attributed to the ticking actor or component
+ * if tick profiler is active, otherwise only callstacks identify the requester. Callstacks are captured for every unique load and symbolized only when reported.
+ */
+class COMMONAUTOMATION_API FSyncLoadDetector
+{
+public:
+	explicit FSyncLoadDetector(ESyncLoadPolicy InPolicy);
+	~FSyncLoadDetector();
+
+	FSyncLoadDetector(const FSyncLoadDetector& Other) = delete;
+	FSyncLoadDetector& operator=(const FSyncLoadDetector& Other) = delete;
+
+	/** record loads only while active. Automation world activates detector for the duration of a frame */
+	FORCEINLINE void SetActive(bool bInActive, uint64 InFrame = 0) { bActive = bInActive; Frame = InFrame; }
+	/** attribute loads to tick functions profiled by @InTickProfiler */
+	FORCEINLINE void SetTickProfiler(const FTickProfiler* InTickProfiler) { TickProfiler = InTickProfiler; }
+	FORCEINLINE ESyncLoadPolicy GetPolicy() const { return Policy; }
+
+	FORCEINLINE const TArray<FSyncLoad>& GetSyncLoads() const { return SyncLoads; }
+	/** @return human readable report of @SyncLoad, including symbolized callstack */
+	static FString FormatSyncLoad(const FSyncLoad& SyncLoad);
+
+private:
+	void HandleSyncLoadPackage(const FString& PackageName);
+	
+	TArray<FSyncLoad> SyncLoads;
+	/** sync load index by hash of package, requester and callstack */
+	TMap<uint32, int32> SyncLoadIndices;
+	
+	const FTickProfiler* TickProfiler = nullptr;
+	FDelegateHandle SyncLoadHandle;
+	uint64 Frame = 0;
+	ESyncLoadPolicy Policy = ESyncLoadPolicy::Error;
+	bool bActive = false;
+};
+
+}
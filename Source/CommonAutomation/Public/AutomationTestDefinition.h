@@ -68,4 +68,41 @@
 		TClass TClass##AutomationSpecInstance( TEXT(#TClass) ); \
 	}
 
+// spec that shares a single automation world across all It blocks, requires AutomationWorldFixture.h
+// @see FAutomationWorldSpecBase
+#define BEGIN_DEFINE_AUTOMATION_WORLD_SPEC(TClass, PrettyName, TFlags) \
+	BEGIN_DEFINE_CUSTOM_SPEC_PRIVATE(TClass, FAutomationWorldSpecBase, PrettyName, TFlags, __FILE__, __LINE__)
+
+#define END_DEFINE_AUTOMATION_WORLD_SPEC(TClass) \
+	END_DEFINE_CUSTOM_SPEC(TClass)
+
+// benchmark test with warmup, repetitions and statistics, requires AutomationBenchmark.h
+// @see FAutomationBenchmarkBase
+#define BEGIN_AUTOMATION_BENCHMARK_PRIVATE(TClass, TBaseClass, PrettyName, TFlags, FileName, LineNumber) \
+	class TClass : public TBaseClass \
+	{ \
+	public: \
+		TClass( const FString& InName ) \
+		: TBaseClass( InName, true ) { \
+		} \
+		virtual EAutomationTestFlags GetTestFlags() const override { return TFlags; } \
+		virtual FString GetTestSourceFileName() const override { return FileName; } \
+		virtual int32 GetTestSourceFileLine() const override { return LineNumber; } \
+	protected: \
+		virtual FString GetBeautifiedTestName() const override { return PrettyName; } \
+		virtual void Define() override;
+
+#define BEGIN_AUTOMATION_BENCHMARK(TClass, PrettyName, TFlags) \
+	BEGIN_AUTOMATION_BENCHMARK_PRIVATE(TClass, FAutomationBenchmarkBase, PrettyName, TFlags, __FILE__, __LINE__)
+
+#define BEGIN_CUSTOM_AUTOMATION_BENCHMARK(TClass, TBaseClass, PrettyName, TFlags) \
+	BEGIN_AUTOMATION_BENCHMARK_PRIVATE(TClass, TBaseClass, PrettyName, TFlags, __FILE__, __LINE__)
+
+#define END_AUTOMATION_BENCHMARK(TClass) \
+	}; \
+	namespace \
+	{ \
+		TClass TClass##AutomationBenchmarkInstance( TEXT(#TClass) ); \
+	}
+
 #endif
\ No newline at end of file
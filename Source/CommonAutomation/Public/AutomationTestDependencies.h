@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FAutomationTestBase;
+
+namespace UE::Automation
+{
+
+class FPackageLoadTracker;
+
+/** Dependencies recorded for a single test */
+struct FTestDependencies
+{
+	/** packages loaded by automation worlds of the test */
+	TSet<FName> Packages;
+	/** classes instantiated by automation worlds of the test, empty if class tracking was disabled */
+	TSet<FString> Classes;
+	/** modules of instantiated native classes */
+	TSet<FName> Modules;
+	/** test source file, changes to it always select the test */
+	FString SourceFile;
+	FDateTime Timestamp;
+};
+
+/** Result of affected tests selection */
+struct FTestSelection
+{
+	/** if set, dependency map can't be trusted for a given change and all tests should run */
+	bool bFullRun = false;
+	/** reason for the full run */
+	FString Reason;
+	/** tests affected by the change, sorted */
+	TArray<FString> Tests;
+};
+
+/**
+ * Local map from full test path to packages, classes and modules its automation worlds depended on, stored as json under Saved/Automation.
+ * Automation worlds record into it if CommonAutomation.TrackTestDependencies is set. A test entry is replaced by the first world
+ * of the test in a session, further worlds of the same test extend it.
+ * Given a list of changed files, map selects affected tests and falls back to a full run if it can't map a change to tests.
+ */
+class COMMONAUTOMATION_API FTestDependencyMap
+{
+public:
+	static constexpr int32 Version = 2;
+	
+	explicit FTestDependencyMap(const FString& InFilename = GetDefaultFilename());
+
+	/** load map file, @return false if file doesn't exist, can't be parsed or has a different version */
+	bool Load();
+	/** write map file */
+	bool Save() const;
+
+	/**
+	 * record dependencies of @TestName from @Tracker. Packages that were already in memory are never loaded, so @WorldPackage,
+	 * if set, is recorded together with its asset registry dependency closure
+	 */
+	void Record(const FString& TestName, const FString& SourceFile, const FPackageLoadTracker& Tracker, FName WorldPackage = NAME_None);
+	/** record dependencies of @TestName, @see Record */
+	void Record(const FString& TestName, FTestDependencies&& Dependencies);
+
+	const FTestDependencies* Find(const FString& TestName) const;
+	FORCEINLINE const TMap<FString, FTestDependencies>& GetTests() const { return Tests; }
+	FORCEINLINE bool IsEmpty() const { return Tests.IsEmpty(); }
+	/** @return oldest test entry timestamp */
+	FDateTime GetOldestTimestamp() const;
+
+	/**
+	 * select tests affected by @ChangedFiles. Each entry is either a long package name, a content file or a source file
+	 * Content files are mapped to packages, source files are mapped to modules by the closest *.Build.cs file
+	 * Full run is requested if map is empty, older than @MaxAgeDays or a change can't be mapped to a package or a recorded module
+	 */
+	FTestSelection SelectAffectedTests(TConstArrayView<FString> ChangedFiles, double MaxAgeDays = 7.0) const;
+
+	/**
+	 * @return map automation worlds record into during this session. Map is loaded on first use and saved when test pass ends
+	 */
+	static FTestDependencyMap& GetSessionMap();
+	/**
+	 * @return full path of the running @Test as listed by FAutomationTestInfo::GetFullTestPath, e.g. "Project.Feature.Test"
+	 * Complex tests and specs are resolved to the path of the running parameter, e.g. the current It block
+	 */
+	static FString GetTestPath(const FAutomationTestBase& Test);
+	/** @return @Package and packages it hard depends on, directly or indirectly, according to asset registry */
+	static TSet<FName> GetDependencyClosure(FName Package);
+	/** @return module name of a source file, NAME_None if file doesn't belong to a module */
+	static FName GetSourceFileModule(const FString& SourceFile);
+	static FString GetDefaultFilename();
+
+private:
+	FString Filename;
+	TMap<FString, FTestDependencies> Tests;
+	/** tests recorded during this session, their entries are extended rather than replaced */
+	TSet<FString> RecordedTests;
+};
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "UObject/ObjectKey.h"
+
+class UWorld;
+
+namespace UE::Automation
+{
+
+/** Accumulated tick cost for a single actor/component instance or for a class */
+struct FTickProfileEntry
+{
+	/** instance path name or class name */
+	FString Name;
+	/** tick group, set only for instance entries */
+	TEnumAsByte<ETickingGroup> TickGroup = TG_MAX;
+	/** target class */
+	FName ClassName = NAME_None;
+	/** total time spent in tick functions */
+	double TotalTimeMs = 0.0;
+	/** number of executed tick functions */
+	int32 NumTicks = 0;
+
+	FORCEINLINE double GetAverageTimeMs() const { return NumTicks > 0 ? TotalTimeMs / NumTicks : 0.0; }
+};
+
+/**
+ * Attributes tick time to actors and components ticked by automation world.
+ * Primary actor and component tick functions are replaced with timed proxies that keep original tick group, interval and prerequisites.
+ * Proxies run on game thread, so tick functions that normally run on any thread are serialized while profiling.
+ * Secondary tick functions (e.g. movement component pre-physics ticks) are not attributed.
+ * Original tick functions are restored when profiler is destroyed or rebound to another world.
+ */
+class COMMONAUTOMATION_API FTickProfiler
+{
+public:
+	explicit FTickProfiler(UWorld* InWorld);
+	~FTickProfiler();
+
+	FTickProfiler(const FTickProfiler& Other) = delete;
+	FTickProfiler& operator=(const FTickProfiler& Other) = delete;
+
+	/** replace newly registered tick functions with timed proxies. Called by automation world before each frame */
+	void WrapTickFunctions();
+	/** restore original tick functions */
+	void RestoreTickFunctions();
+	/** restore tick functions for the current world and profile @InWorld instead. Accumulated stats are kept */
+	void SetWorld(UWorld* InWorld);
+	/** reset accumulated stats */
+	void ResetStats();
+
+	/** @return top @NumEntries instances sorted by total tick time */
+	TArray<FTickProfileEntry> GetTopInstances(int32 NumEntries) const;
+	/** @return top @NumEntries classes sorted by total tick time */
+	TArray<FTickProfileEntry> GetTopClasses(int32 NumEntries) const;
+	/** @return top @NumEntries instances sorted by tick time during the last profiled frame */
+	TArray<FTickProfileEntry> GetTopInstancesInLastFrame(int32 NumEntries) const;
+	/** @return accumulated tick time for all instances of @Class, including child classes */
+	double GetClassTickTimeMs(const UClass* Class) const;
+	/** @return number of profiled frames */
+	FORCEINLINE int32 GetNumFrames() const { return NumFrames; }
+	/** @return target of the profiled tick function that is currently executing on game thread */
+	FORCEINLINE UObject* GetCurrentTarget() const { return CurrentTarget; }
+
+private:
+	struct FProfiledTickFunction;
+	
+	struct FInstanceStats
+	{
+		FString Name;
+		TWeakObjectPtr<UClass> Class;
+		uint64 TotalCycles = 0;
+		int32 NumTicks = 0;
+		/** tick time during @Frame */
+		uint64 FrameCycles = 0;
+		int32 Frame = INDEX_NONE;
+		/** tick group of the original tick function */
+		TEnumAsByte<ETickingGroup> TickGroup = TG_PrePhysics;
+	};
+
+	void WrapTickFunction(FTickFunction& TickFunction, UObject* Target, ULevel* Level);
+	void UpdatePrerequisites();
+	
+	UWorld* World = nullptr;
+	/** timed proxies, keyed by original tick function */
+	TMap<FTickFunction*, TUniquePtr<FProfiledTickFunction>> Proxies;
+	/** accumulated stats per tick target. Stats are referenced by proxies, so they are allocated separately */
+	TMap<FObjectKey, TUniquePtr<FInstanceStats>> Instances;
+	int32 NumFrames = 0;
+	/** target of the currently executing proxy */
+	UObject* CurrentTarget = nullptr;
+};
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace UE::Automation
+{
+
+/**
+ * Conditional trace capture for automation world lifetime.
+ * CPU, loading and memory tag trace channels are enabled while capture is alive, trace events are kept in trace tail buffer.
+ * Captured window is written to a .utrace file named after the test if the test exceeds its time budget or automation world hitches,
+ * otherwise trace data is discarded as tail buffer wraps around. Window size is bounded by the tail buffer size (-tracetailmb).
+ * Nothing is captured if trace is already connected to a file or trace server, as a full trace is recorded anyway.
+ */
+class COMMONAUTOMATION_API FTraceCapture
+{
+public:
+	/** @InBudgetSeconds time budget for captured window, zero or negative means trace is written only on hitches */
+	explicit FTraceCapture(double InBudgetSeconds);
+	~FTraceCapture();
+
+	FTraceCapture(const FTraceCapture& Other) = delete;
+	FTraceCapture& operator=(const FTraceCapture& Other) = delete;
+
+	/** mark captured window as worth writing */
+	void MarkHitch(uint64 Frame);
+	/** @return true if captured window exceeded time budget or hitched */
+	bool ShouldWrite() const;
+	/**
+	 * finish capture and conditionally write captured window to a trace file named after @TestName
+	 * @return written file path, or empty string if trace was discarded
+	 */
+	FString Finish(const FString& TestName);
+
+	/** @return directory trace files are written to */
+	static FString GetTraceDirectory();
+
+private:
+	/** channels enabled by this capture, disabled when capture is destroyed */
+	TArray<FString> EnabledChannels;
+	double StartTime = 0.0;
+	double BudgetSeconds = 0.0;
+	/** first hitched frame, zero if no hitches were recorded */
+	uint64 FirstHitchFrame = 0;
+	bool bHitched = false;
+	bool bFinished = false;
+};
+
+}
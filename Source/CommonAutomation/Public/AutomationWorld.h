@@ -1,11 +1,13 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "AutomationLoadTracker.h"
 #include "Engine/World.h"
 #include "Engine/EngineTypes.h"
 #include "EngineUtils.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "Subsystems/GameInstanceSubsystem.h"
+#include "WorldPartition/DataLayer/DataLayerType.h"
 
 class UAutomationGameInstance;
 class UWorld;
@@ -15,7 +17,22 @@ class ULocalPlayer;
 class FAutomationWorld;
 class UWorldSubsystem;
 class UGameInstanceSubsystem;
+class UDataLayerInstance;
 struct FAutomationWorldInitParams;
+struct FStreamableHandle;
+
+namespace UE::Automation
+{
+	class FWorldTaskScheduler;
+	struct FWorldTaskAwaiter;
+	class FTickProfiler;
+	class FFrameTimingRecorder;
+	class FTraceCapture;
+	class FWorldUsageProbe;
+	class FSyncLoadDetector;
+	class FAssetStubs;
+	enum class ESyncLoadPolicy: uint8;
+}
 
 enum class EWorldInitFlags: uint32
 {
@@ -35,8 +52,11 @@ enum class EWorldInitFlags: uint32
 	CreateGameInstance  = 1 << 11,	// creates game instance and game mode during initialization. By default, automation world runs without them
 	CreateLocalPlayer	= 1 << 12,	// creates local player during initialization
 	StartPlay			= 1 << 13,	// calls BeginPlay during initialization
+	LazyScene			= 1 << 14,	// If set, FScene is created when the first visible primitive is registered or EnsureScene is called. Ignored if world requires HitProxy, FX, physics or collision
+	StubAssets			= 1 << 16,	// If set, heavy assets referenced by a loaded world are replaced with empty stubs, see UE::Automation::FAssetStubs. Static meshes are kept if world inits collision or physics
+	PreloadExternalActorDependencies = 1 << 17, // If set, dependencies of external actors loaded together with a world partition or one file per actor world are requested as a single batch of async loads before world is loaded
 
-	// @todo investigate if InitScene can be removed from default options
+	// @todo investigate if InitScene can be removed from default options. Add LazyScene for worlds that don't render or trace
 	Minimal				= InitScene | StartPlay,											// initializes scene and calls BeginPlay for game worlds
 	WithBeginPlay		= InitScene | StartPlay,											// alternative to Minimal
 	WithGameInstance	= InitScene | StartPlay | CreateGameInstance,						// same as WithBeginPlay, but also creates game instance
@@ -44,6 +64,13 @@ enum class EWorldInitFlags: uint32
 };
 ENUM_CLASS_FLAGS(EWorldInitFlags)
 
+enum class EBatchSpawnFlags: uint8
+{
+	None				= 0,
+	SkipOverlapUpdates	= 1 << 0,	// If set, initial overlaps are not updated for native primitive components of spawned actors
+};
+ENUM_CLASS_FLAGS(EBatchSpawnFlags)
+
 using FAutomationWorldPtr = TSharedPtr<FAutomationWorld>;
 using FAutomationWorldRef = TSharedRef<FAutomationWorld>;
 
@@ -132,6 +159,83 @@ struct COMMONAUTOMATION_API FAutomationWorldInitParams
 		return *this;
 	}
 	
+	/**
+	 * load only actors of @T and derived classes from world package, streaming levels and world partition cells
+	 * Actors required by the level (world settings, level script actor, default brush, data layers) and spawned actors are never filtered
+	 * Actors of editor world partition load regions are filtered by their descriptors and never loaded. Other actors are loaded
+	 * and removed from the level, kept actors attached to a removed actor are detached from it
+	 */
+	template <typename T, TEMPLATE_REQUIRES(TIsDerivedFrom<T, AActor>::Value)>
+	FAutomationWorldInitParams& IncludeActors()
+	{
+		IncludeActorClasses.AddUnique(T::StaticClass());
+		return *this;
+	}
+
+	/** don't load actors of @T and derived classes. Exclusion takes precedence over inclusion */
+	template <typename T, TEMPLATE_REQUIRES(TIsDerivedFrom<T, AActor>::Value)>
+	FAutomationWorldInitParams& ExcludeActors()
+	{
+		ExcludeActorClasses.AddUnique(T::StaticClass());
+		return *this;
+	}
+
+	FORCEINLINE FAutomationWorldInitParams& IncludeActors(TSubclassOf<AActor> ActorClass)
+	{
+		IncludeActorClasses.AddUnique(ActorClass);
+		return *this;
+	}
+
+	FORCEINLINE FAutomationWorldInitParams& ExcludeActors(TSubclassOf<AActor> ActorClass)
+	{
+		ExcludeActorClasses.AddUnique(ActorClass);
+		return *this;
+	}
+	
+	/**
+	 * set state of world partition data layer, specified by data layer asset name, data layer instance name, short or full name
+	 * Asset and instance names are the ones UE::Automation::FActorDescInfo reports, so queried data layers can be passed as is
+	 * Runtime state is applied before the first streaming update, so cells of unloaded data layers are never loaded.
+	 * In editor worlds data layer is loaded in editor unless @State is Unloaded
+	 */
+	FORCEINLINE FAutomationWorldInitParams& SetDataLayerState(FName DataLayer, EDataLayerRuntimeState State)
+	{
+		DataLayerStates.Add(DataLayer, State);
+		return *this;
+	}
+
+	/**
+	 * load world partition actors intersecting @Region into editor world, through editor loader adapter
+	 * Actors outside of load regions stay unloaded, except for always loaded actors.
+	 * Load regions are ignored for game worlds, their streaming is driven by streaming sources
+	 */
+	FORCEINLINE FAutomationWorldInitParams& AddLoadRegion(const FBox& Region)
+	{
+		LoadRegions.Add(Region);
+		return *this;
+	}
+
+	/** load world partition actors intersecting bounds of location volume (or any other actor) with @ActorLabel into editor world */
+	FORCEINLINE FAutomationWorldInitParams& AddLoadRegion(FName ActorLabel)
+	{
+		LoadRegionActors.AddUnique(ActorLabel);
+		return *this;
+	}
+
+	/** unload data layers that are not set via SetDataLayerState, so that only specified data layers are loaded */
+	FORCEINLINE FAutomationWorldInitParams& UnloadOtherDataLayers()
+	{
+		bUnloadOtherDataLayers = true;
+		return *this;
+	}
+	
+	/** fail the test if world creation exceeds load @Budget, @see UE::Automation::FLoadBudget */
+	FORCEINLINE FAutomationWorldInitParams& AddLoadBudget(const UE::Automation::FLoadBudget& Budget)
+	{
+		LoadBudgets.Add(Budget);
+		return *this;
+	}
+	
 	FORCEINLINE FAutomationWorldInitParams& SetInitWorld(TDelegate<void(UWorld*)>&& Callback)
 	{
 		InitWorld = Callback;
@@ -167,7 +271,22 @@ struct COMMONAUTOMATION_API FAutomationWorldInitParams
 	/** @return world initialization values produced from this params */
 	FWorldInitializationValues CreateWorldInitValues() const;
 	bool ShouldInitScene() const;
+	/** @return true if scene creation is deferred until it is required */
+	bool ShouldDeferScene() const;
 	bool ShouldInitWorldPartition() const;
+	/** @return true if include or exclude actor filter is set */
+	FORCEINLINE bool HasActorFilter() const { return !IncludeActorClasses.IsEmpty() || !ExcludeActorClasses.IsEmpty(); }
+	/** @return whether loaded @Actor passes include and exclude actor filters */
+	bool ShouldLoadActor(const AActor* Actor) const;
+	/** @return whether actors of @ActorClass pass include and exclude actor filters */
+	bool ShouldLoadActorClass(const UClass* ActorClass) const;
+	/**
+	 * @return packages that external actors loaded together with world package depend on, excluding world and actor packages themselves
+	 * Editor worlds include actors of load regions, game worlds only include always loaded actors of world partition maps
+	 */
+	TArray<FName> GatherExternalActorDependencies() const;
+	/** @return state set for @DataLayer by any of its names, @see SetDataLayerState. @OutDataLayer is set to the matched name */
+	const EDataLayerRuntimeState* FindDataLayerState(const UDataLayerInstance* DataLayer, FName* OutDataLayer = nullptr) const;
 
 	FORCEINLINE bool	HasWorldPackage() const { return WorldPackage.IsSet(); }
 	FORCEINLINE FString GetWorldPackage() const { return WorldPackage.GetValue(); }
@@ -205,6 +324,24 @@ struct COMMONAUTOMATION_API FAutomationWorldInitParams
 	/** A list of local player subsystems that would be created as part of automation world */
 	TArray<UClass*> PlayerSubsystems;
 
+	/** load budgets checked after world is created */
+	TArray<UE::Automation::FLoadBudget> LoadBudgets;
+
+	/** if not empty, only loaded actors of these classes are kept */
+	TArray<UClass*> IncludeActorClasses;
+	/** loaded actors of these classes are removed before their components are registered */
+	TArray<UClass*> ExcludeActorClasses;
+
+	/** data layer states, by data layer asset name or label */
+	TMap<FName, EDataLayerRuntimeState> DataLayerStates;
+	/** if set, data layers not listed in @DataLayerStates are unloaded */
+	bool bUnloadOtherDataLayers = false;
+
+	/** regions loaded into editor world partition */
+	TArray<FBox> LoadRegions;
+	/** labels of actors whose bounds are loaded into editor world partition */
+	TArray<FName> LoadRegionActors;
+
 	static const FAutomationWorldInitParams Minimal;
 	static const FAutomationWorldInitParams WithBeginPlay;
 	static const FAutomationWorldInitParams WithGameInstance;
@@ -247,6 +384,8 @@ using FWorldInitParams = FAutomationWorldInitParams;
  *		});
  *	}
  *
+ *	Specs that don't need a fresh world for every It block can share one with FAutomationWorldFixture, @see FAutomationWorldSpecBase
+ *
  *	CreateWorld function family creates a new empty world from scratch.
  *	LoadWorld	function family requires a valid world package located on disk or in memory.
  *	Use LoadWorld only for tests that require explicit setup in editor, like pathfinding or building navigation. Otherwise, prefer creating world from scratch.
@@ -298,7 +437,7 @@ public:
 		return CreateGameWorldWithPlayer(TGameMode::StaticClass(), InitFlags);
 	}
 	
-	/** Creates an editor world and initializes it */
+	/** Creates an editor world and initializes it. Editor worlds are supported only in editor builds, returns nullptr otherwise */
 	static FAutomationWorldPtr CreateEditorWorld(EWorldInitFlags InitFlags = EWorldInitFlags::WithBeginPlay);
 
 	/**
@@ -335,12 +474,14 @@ public:
 	template <typename T, TEMPLATE_REQUIRES(TIsDerivedFrom<T, UGameInstanceSubsystem>::Value)>
 	T* GetSubsystem()
 	{
+		NotifySubsystemAccessed(T::StaticClass());
 		return CastChecked<T>(GameInstance->GetSubsystem<T>(), ECastCheckedType::NullAllowed);
 	}
 
 	template <typename T, TEMPLATE_REQUIRES(TIsDerivedFrom<T, UWorldSubsystem>::Value)>
 	T* GetSubsystem()
 	{
+		NotifySubsystemAccessed(T::StaticClass());
 		return CastChecked<T>(World->GetSubsystem<T>(), ECastCheckedType::NullAllowed);
 	}
 
@@ -375,6 +516,87 @@ public:
 	/** tick active world */
 	void TickWorld(int32 NumFrames);
 
+	// awaitables for UE::Automation::FWorldTask coroutines, resumed from TickWorld. Require AutomationWorldTask.h
+	/** @return awaitable that resumes the task after @NumFrames are ticked */
+	UE::Automation::FWorldTaskAwaiter Frames(int32 NumFrames);
+	/** @return awaitable that resumes the task after @NumSeconds of world time are ticked */
+	UE::Automation::FWorldTaskAwaiter Seconds(double NumSeconds);
+	/** @return awaitable that resumes the task at the end of the first frame @Predicate returns true */
+	UE::Automation::FWorldTaskAwaiter Until(TFunction<bool()> Predicate);
+	/** @return awaitable that resumes the task after async load handle completes or is canceled */
+	UE::Automation::FWorldTaskAwaiter Loaded(TSharedPtr<FStreamableHandle> Handle);
+
+	/**
+	 * start attributing tick time to actors and components ticked by this world, @see UE::Automation::FTickProfiler
+	 * Profiling can also be enabled for every automation world with CommonAutomation.ProfileTicks
+	 */
+	void StartTickProfiling();
+	/** stop tick profiling and restore original tick functions. Accumulated stats are discarded */
+	void StopTickProfiling();
+	/** @return tick profiler if tick profiling is active */
+	const UE::Automation::FTickProfiler* GetTickProfiler() const;
+	/** add top @NumEntries tick classes and instances to the current test output */
+	void ReportTickProfile(int32 NumEntries = 10) const;
+
+	/** @return per-frame timings recorded by TickWorld, @see UE::Automation::FFrameTimingRecorder. Requires AutomationFrameTiming.h */
+	const UE::Automation::FFrameTimingRecorder& GetFrameTimings() const;
+	/**
+	 * record a hitch for every frame that takes longer than @ThresholdMs on game thread. Zero disables hitch detection
+	 * If @bCaptureTickFunctions is set, tick profiling is started to attribute hitches to tick functions
+	 * Hitch detection can also be enabled for every automation world with CommonAutomation.HitchThresholdMs
+	 */
+	void SetHitchThreshold(double ThresholdMs, bool bCaptureTickFunctions = false);
+	/** add frame time percentiles and recorded hitches to the current test output */
+	void ReportFrameTimings() const;
+
+	/**
+	 * keep trace events in memory for the lifetime of this world, @see UE::Automation::FTraceCapture
+	 * Captured trace is written to a file named after the current test if world lives longer than @BudgetSeconds or a frame hitches.
+	 * Hitches are detected only if hitch threshold is set. Capture can also be enabled for every automation world with CommonAutomation.TraceCapture
+	 */
+	void StartTraceCapture(double BudgetSeconds = 0.0);
+
+	/**
+	 * start observing which engine systems this world uses, @see UE::Automation::FWorldUsageProbe
+	 * Minimal init flags are reported to the current test when world is destroyed.
+	 * Probe can also be enabled for every automation world with CommonAutomation.ProbeInitFlags
+	 */
+	void StartUsageProbe();
+	/** @return usage probe if it is active. Requires AutomationWorldUsage.h */
+	const UE::Automation::FWorldUsageProbe* GetUsageProbe() const;
+
+	/**
+	 * @return packages loaded since world creation started, attributed to load phases
+	 * Instantiated classes are tracked only if CommonAutomation.TrackTestDependencies is set
+	 */
+	const UE::Automation::FPackageLoadTracker& GetLoadTracker() const;
+	/** @return load stats of @Phase, or of all world creation phases if @Phase is unset */
+	UE::Automation::FLoadPhaseStats GetLoadStats(TOptional<UE::Automation::ELoadPhase> Phase = {}) const;
+	/** add an error to the current test for every violation of load @Budget. @return true if budget is met */
+	bool CheckLoadBudget(const UE::Automation::FLoadBudget& Budget) const;
+	/** add load stats of every phase and top @NumPackages heaviest packages to the current test output */
+	void ReportLoadCost(int32 NumPackages = 10) const;
+	/** @return number of loaded actors removed by include and exclude actor filters */
+	FORCEINLINE int32 GetNumFilteredActors() const { return NumFilteredActors; }
+	/** @return asset stubs substituted for world dependencies if world was loaded with StubAssets flag. Requires AutomationAssetStubs.h */
+	const UE::Automation::FAssetStubs* GetAssetStubs() const;
+
+	/**
+	 * report blocking package loads made while TickWorld ticks frames, @see UE::Automation::FSyncLoadDetector
+	 * Loads are attributed to ticking actors and components only while tick profiling is active. @bAttributeRequesters starts it,
+	 * at the cost of ticking through profiler proxies. Deduplicated loads are reported when world is destroyed.
+	 * Detection can also be enabled for every automation world with CommonAutomation.DetectSyncLoads and CommonAutomation.AttributeSyncLoads
+	 */
+	void StartSyncLoadDetection(UE::Automation::ESyncLoadPolicy Policy, bool bAttributeRequesters = false);
+	/** @return sync load detector if detection is active. Requires AutomationSyncLoadDetector.h */
+	const UE::Automation::FSyncLoadDetector* GetSyncLoadDetector() const;
+
+	/**
+	 * tick world until all suspended world tasks are resumed and either complete or wait on something other than this world
+	 * @return true if there are no suspended tasks left, false if @MaxFrames were ticked
+	 */
+	bool RunTasks(int32 MaxFrames = 600);
+
 	/** route end play event to world and actors */
 	void RouteEndPlay() const;
 
@@ -396,6 +618,8 @@ public:
 
 	/** @return active world */
 	UWorld* GetWorld() const;
+	/** create FScene if scene creation was deferred with EWorldInitFlags::LazyScene. Call before using systems that require render scene */
+	void EnsureScene();
 	/** @return world context */
 	FWorldContext* GetWorldContext() const;
 	/** @return game instance */
@@ -428,6 +652,42 @@ public:
 		return CastChecked<T>(GetWorld()->SpawnActor(T::StaticClass(), &Identity, SpawnParams), ECastCheckedType::NullAllowed);
 	}
 	
+	/**
+	 * Spawn @Count actors of a given class in a batch, @see SpawnActors overload with transforms
+	 * @return spawned actors
+	 */
+	template <typename T = AActor>
+	TArray<T*> SpawnActors(int32 Count, UClass* Class = T::StaticClass(), FActorSpawnParameters SpawnParams = FActorSpawnParameters{}, EBatchSpawnFlags Flags = EBatchSpawnFlags::None)
+	{
+		TArray<FTransform> Transforms;
+		Transforms.Init(FTransform::Identity, Count);
+		
+		return SpawnActors<T>(Transforms, Class, MoveTemp(SpawnParams), Flags);
+	}
+
+	/**
+	 * Spawn an actor for each transform in a batch.
+	 * All actors are spawned deferred first, then FinishSpawning is called for each of them in a second pass
+	 * with navigation octree updates locked until the whole batch is spawned.
+	 * Spawn name is ignored for more than one actor.
+	 * @return spawned actors
+	 */
+	template <typename T = AActor>
+	TArray<T*> SpawnActors(TConstArrayView<FTransform> Transforms, UClass* Class = T::StaticClass(), FActorSpawnParameters SpawnParams = FActorSpawnParameters{}, EBatchSpawnFlags Flags = EBatchSpawnFlags::None)
+	{
+		check(Class && Class->IsChildOf(T::StaticClass()));
+		const TArray<AActor*> Actors = SpawnActorsBatched(Class, Transforms, MoveTemp(SpawnParams), Flags);
+		
+		TArray<T*> Result;
+		Result.Reserve(Actors.Num());
+		for (AActor* Actor: Actors)
+		{
+			Result.Add(CastChecked<T>(Actor));
+		}
+
+		return Result;
+	}
+	
 	/** @return actor with a given tag */
 	template <typename T = AActor>
 	T* FindActorByTag(FName Tag)
@@ -466,7 +726,9 @@ public:
 	FAutomationWorld& operator=(FAutomationWorld&& Other) = delete;
 private:
 
-	FAutomationWorld(UWorld* NewWorld, const FAutomationWorldInitParams& InitParams);
+	friend class FAutomationWorldFixture;
+	
+	FAutomationWorld(UWorld* NewWorld, const FAutomationWorldInitParams& InitParams, TUniquePtr<UE::Automation::FPackageLoadTracker>&& InLoadTracker);
 
 	void HandleTestCompleted(FAutomationTestBase* Test);
 	void HandleLevelStreamingStateChange(UWorld* OtherWorld, const ULevelStreaming* LevelStreaming, ULevel* LevelIfLoaded, ELevelStreamingState PrevState, ELevelStreamingState NewState);
@@ -475,10 +737,27 @@ private:
 	void InitializeWorldPartition(UWorld* InWorld);
 	
 	USubsystem* AddAndInitializeSubsystem(FSubsystemCollectionBase* Collection, TSubclassOf<USubsystem> SubsystemClass, UObject* Outer);
+	/** mark subsystem as used by the test for usage probe */
+	void NotifySubsystemAccessed(const UClass* SubsystemClass) const;
 	
 	void CreateGameInstance(const FAutomationWorldInitParams& InitParams);
 	void CreateViewportClient();
 
+	UE::Automation::FWorldTaskScheduler& GetTaskScheduler();
+	
+	TArray<AActor*> SpawnActorsBatched(UClass* Class, TConstArrayView<FTransform> Transforms, FActorSpawnParameters SpawnParams, EBatchSpawnFlags Flags);
+
+	/** create deferred scene if @Component is a visible primitive of this world */
+	void HandleComponentRegistered(UActorComponent* Component);
+	/** create deferred scene if any primitive registered in the world requires it. Called once on world creation, further registrations are handled as they happen */
+	void UpdateDeferredScene();
+	/** remove actors of @Level that don't pass actor filters of init params, before their components are registered */
+	void FilterLevelActors(ULevel* Level);
+	/** apply data layer states of init params to world partition data layers */
+	void ApplyDataLayerStates();
+	/** load actors of init params load regions into editor world partition */
+	void LoadEditorRegions();
+
 	/** Cached pointer to a world subsystem collection, retrieved in a fancy way from @World */
 	FObjectSubsystemCollection<UWorldSubsystem>* WorldCollection = nullptr;
 	/**
@@ -497,8 +776,15 @@ private:
 	uint64 InitialFrameCounter = 0;
 	/** Handle to TestEndEvent delegate */
 	FDelegateHandle TestCompletedHandle;
+	/**
+	 * Test that owns automation world through a world fixture. End of test safety check is skipped for this test,
+	 * because fixture world lives across multiple test runs and is destroyed by the fixture itself
+	 */
+	const FAutomationTestBase* FixtureTest = nullptr;
 	/** Handle to LevelStreamingStateChanged delegate */
 	FDelegateHandle StreamingStateHandle;
+	/** Handle to global component registration delegate, bound while scene creation is deferred */
+	FDelegateHandle ComponentRegisteredHandle;
 
 	/** cached init params for this automation world */
 	FWorldInitParams CachedInitParams;
@@ -508,6 +794,46 @@ private:
 	/** cached tick type, different for game and editor world */
 	ELevelTick TickType = LEVELTICK_All;
 
+	/** number of frames ticked by this automation world */
+	uint64 TickedFrames = 0;
+	/** simulated time ticked by this automation world */
+	double TickedTime = 0.0;
+	/** scheduler for suspended world tasks, created on first await */
+	TUniquePtr<UE::Automation::FWorldTaskScheduler> TaskScheduler;
+	/** tick profiler, created if tick profiling is requested */
+	TUniquePtr<UE::Automation::FTickProfiler> TickProfiler;
+	/** per-frame timings and hitches */
+	TUniquePtr<UE::Automation::FFrameTimingRecorder> FrameTimings;
+	/** conditional trace capture, created if trace capture is requested */
+	TUniquePtr<UE::Automation::FTraceCapture> TraceCapture;
+	/** sync load detector, created if sync load detection is requested */
+	TUniquePtr<UE::Automation::FSyncLoadDetector> SyncLoadDetector;
+	/** world usage probe, created if init flags recommendation is requested */
+	TUniquePtr<UE::Automation::FWorldUsageProbe> UsageProbe;
+	/** package and class load tracker, created before world package is loaded */
+	TUniquePtr<UE::Automation::FPackageLoadTracker> LoadTracker;
+	/** stubs substituted for world dependencies, kept alive for the lifetime of the world */
+	TUniquePtr<UE::Automation::FAssetStubs> AssetStubs;
+	/** time spent in CreateWorld */
+	double CreationTimeMs = 0.0;
+	/** number of loaded actors removed by actor filters */
+	int32 NumFilteredActors = 0;
+	/** used physical memory before world creation, peak used memory is recorded relative to it */
+	uint64 InitialUsedMemory = 0;
+	/** peak used physical memory, sampled after world creation and every TickWorld call */
+	uint64 PeakUsedMemory = 0;
+
+	/** report init flags recommendation to the current test, fail the test if too many flags are unused and strict check is enabled */
+	void ReportUsage(FAutomationTestBase* Test) const;
+	/** report sync loads recorded during ticks to the current test */
+	void ReportSyncLoads(FAutomationTestBase* Test) const;
+	/** sample used physical memory for performance history */
+	void SampleUsedMemory();
+	/** append world metrics to performance history and report regressions to the current test */
+	void RecordPerfHistory(FAutomationTestBase* Test);
+	/** record packages, classes and modules used by this world to test dependency map */
+	void RecordTestDependencies(FAutomationTestBase* Test) const;
+
 	/** @return world package with an unique name */
 	static UPackage* CreateUniqueWorldPackage(const FString& PackageName, const FString& TestName);
 	static FName CreateUniqueWorldName();
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AutomationWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * Automation world that lives across multiple test runs of a single owning test, e.g. across all It blocks of a spec.
+ * World is created by the first Setup call (BeforeAll semantics) and destroyed either explicitly via Teardown or
+ * automatically when a different test starts or the test pass ends (AfterAll semantics).
+ * Between test runs world is reset cheaply: actors spawned after Setup are destroyed and user reset callback is invoked.
+ *
+ * End of test safety check of FAutomationWorld applies at fixture scope: fixture world can outlive its owning test run,
+ * but it is a fatal error for it to outlive the fixture.
+ * @see FAutomationWorldSpecBase for spec integration
+ */
+class COMMONAUTOMATION_API FAutomationWorldFixture
+{
+public:
+	explicit FAutomationWorldFixture(FAutomationTestBase& InOwningTest);
+	/** unbinds test framework delegates and destroys fixture world, in case test pass was aborted before it ended */
+	~FAutomationWorldFixture();
+
+	FAutomationWorldFixture(const FAutomationWorldFixture& Other) = delete;
+	FAutomationWorldFixture& operator=(const FAutomationWorldFixture& Other) = delete;
+
+	/** set init params used to create fixture world. Existing fixture world is destroyed if params are changed */
+	void SetInitParams(const FAutomationWorldInitParams& InInitParams);
+
+	/** set callback invoked after each test run, after actors spawned by the test run are destroyed */
+	void SetResetCallback(TFunction<void(FAutomationWorld&)>&& InResetCallback);
+
+	/** create fixture world if it doesn't exist yet. @return fixture world */
+	FAutomationWorld& Setup();
+
+	/** reset fixture world to the state it had after Setup. Called after each test run */
+	void ResetWorld();
+
+	/** destroy fixture world and unbind test framework delegates. Safe to call if fixture wasn't set up */
+	void Teardown();
+
+	FORCEINLINE bool IsValid() const { return World.IsValid(); }
+	FORCEINLINE FAutomationWorld* Get() const { return World.Get(); }
+	FORCEINLINE FAutomationWorld* operator->() const { check(World.IsValid()); return World.Get(); }
+	FORCEINLINE FAutomationWorld& operator*() const { check(World.IsValid()); return *World; }
+
+private:
+	
+	void HandleTestStarted(FAutomationTestBase* Test);
+	void HandleAllTestsEnded();
+
+	/** test that owns fixture */
+	FAutomationTestBase& OwningTest;
+	/** init params for a fixture world */
+	TOptional<FAutomationWorldInitParams> InitParams;
+	/** reset callback */
+	TFunction<void(FAutomationWorld&)> ResetCallback;
+
+	FAutomationWorldPtr World;
+	/** world that was created by Setup. If world travel happened during test run, fixture world is recreated */
+	FObjectKey FixtureWorld;
+	/** actors present in the fixture world after Setup */
+	TSet<FObjectKey> FixtureActors;
+
+	FDelegateHandle TestStartedHandle;
+	FDelegateHandle AllTestsEndedHandle;
+};
+
+/**
+ * Base class for specs that share a single automation world across all It blocks
+ * Use BEGIN_DEFINE_AUTOMATION_WORLD_SPEC/END_DEFINE_AUTOMATION_WORLD_SPEC macro family to define such specs:
+ *
+ *	BEGIN_DEFINE_AUTOMATION_WORLD_SPEC(FMySpec, "Project.MySpec", AutomationTestFlags)
+ *	END_DEFINE_AUTOMATION_WORLD_SPEC(FMySpec)
+ *
+ *	void FMySpec::Define()
+ *	{
+ *		UseWorldFixture(FWorldInitParams::WithGameInstance);
+ *
+ *		It("Spawns actor", [this]
+ *		{
+ *			AActor* Actor = WorldFixture->SpawnActor();
+ *			// actor is destroyed after It block, world is kept for the next one
+ *		});
+ *	}
+ */
+class COMMONAUTOMATION_API FAutomationWorldSpecBase: public FAutomationSpecBase
+{
+public:
+	FAutomationWorldSpecBase(const FString& InName, const bool bInComplexTask)
+		: FAutomationSpecBase(InName, bInComplexTask)
+		, WorldFixture(*this)
+	{}
+
+protected:
+
+	/**
+	 * Create fixture world before the first It block and reset it after every It block
+	 * Should be called from Define, before any It block that uses WorldFixture
+	 * @param InitParams init params for fixture world
+	 * @param ResetCallback optional callback to reset world state after each It block
+	 */
+	void UseWorldFixture(const FAutomationWorldInitParams& InitParams, TFunction<void(FAutomationWorld&)> ResetCallback = {});
+	
+	FAutomationWorldFixture WorldFixture;
+};
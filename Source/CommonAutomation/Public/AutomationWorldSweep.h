@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AutomationWorld.h"
+#include "AssetRegistry/ARFilter.h"
+
+namespace UE::Automation
+{
+
+struct FWorldSweepOptions
+{
+	/** init params of every swept world, world package is set by the sweep */
+	FAutomationWorldInitParams InitParams{EWorldType::Game, EWorldInitFlags::Minimal};
+	/**
+	 * garbage is collected after a world is destroyed if loading another world of the largest size seen so far would exceed the cap
+	 * Zero collects garbage after every world
+	 */
+	uint64 MemoryCapMB = 0;
+	/** request async loads of the next world dependencies before callback runs on the current world */
+	bool bPrefetch = true;
+	/** time async loading of prefetched packages may take around the callback and on every tick of the current world */
+	double PrefetchBudgetMs = 2.0;
+	/** add per-world timings to the current test output */
+	bool bReportTimings = true;
+};
+
+/** Timings of a single swept world */
+struct FWorldSweepEntry
+{
+	FName WorldPackage;
+	/** false if world failed to load, callback is not called for such worlds */
+	bool bLoaded = false;
+	double LoadTimeMs = 0.0;
+	double CallbackTimeMs = 0.0;
+	/** time spent destroying the world and collecting garbage after it */
+	double ReleaseTimeMs = 0.0;
+	/** used physical memory after world was loaded */
+	uint64 UsedMemoryMB = 0;
+	/** whether garbage was collected after the world was destroyed */
+	bool bCollectedGarbage = false;
+	/** dependencies requested while the previous world was swept, all of them are loaded before the world is created */
+	TArray<FName> PrefetchedPackages;
+};
+
+/**
+ * @return world packages matching @Filter, sorted by name. Filter is restricted to world assets,
+ * package paths default to CommonAutomationSettings asset paths and are searched recursively
+ */
+COMMONAUTOMATION_API TArray<FName> FindSweepWorlds(FARFilter Filter);
+
+/**
+ * load every world matching @Filter as an automation world, one at a time, and call @Callback for it.
+ * While callback runs on the current world, dependencies of the next world are requested as async loads.
+ * Async loading is processed within @Options.PrefetchBudgetMs before and after the callback and on every tick of the current world,
+ * remaining requests are flushed before the next world is created.
+ * Each world is destroyed before the next one is loaded, garbage is collected before memory exceeds @Options.MemoryCapMB.
+ * Must be called from an automation test.
+ * @return timings of every swept world
+ */
+COMMONAUTOMATION_API TArray<FWorldSweepEntry> SweepWorlds(const FARFilter& Filter, TFunctionRef<void(FAutomationWorld&)> Callback, const FWorldSweepOptions& Options = {});
+
+}
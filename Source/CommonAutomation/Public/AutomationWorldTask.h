@@ -0,0 +1,159 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include <coroutine>
+
+class FAutomationWorld;
+struct FStreamableHandle;
+
+namespace UE::Automation
+{
+
+class FWorldTaskScheduler;
+
+/**
+ * Coroutine type for multi-frame automation test steps driven by FAutomationWorld tick loop.
+ * Task starts executing immediately and is suspended on awaitables returned by FAutomationWorld:
+ *
+ *	FWorldTask SpawnAndWait(FAutomationWorld& World)
+ *	{
+ *		AMyActor* Actor = World.SpawnActor<AMyActor>();
+ *		co_await World.Frames(5);
+ *		co_await World.Until([Actor] { return Actor->IsReady(); });
+ *		co_await World.Seconds(2.0);
+ *	}
+ *
+ *	FWorldTask Task = SpawnAndWait(*World);
+ *	World->RunTasks();
+ *	TestTrue("Task completed", Task.IsDone());
+ *
+ * Suspended tasks are resumed directly from FAutomationWorld::TickWorld, so any number of tasks can share a single tick loop.
+ * Task object should outlive its execution, destroying suspended task cancels it.
+ * Avoid coroutine lambdas with captures: lambda object is destroyed after the first suspension, pass state as parameters instead.
+ */
+class COMMONAUTOMATION_API FWorldTask
+{
+public:
+	struct promise_type
+	{
+		FWorldTask get_return_object() { return FWorldTask{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		// keep coroutine frame alive after completion, so that task state can be queried
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { checkNoEntry(); }
+
+		/** scheduler that currently holds suspended coroutine */
+		FWorldTaskScheduler* Scheduler = nullptr;
+	};
+
+	FWorldTask() = default;
+	FWorldTask(FWorldTask&& Other);
+	FWorldTask& operator=(FWorldTask&& Other);
+	~FWorldTask();
+
+	FWorldTask(const FWorldTask& Other) = delete;
+	FWorldTask& operator=(const FWorldTask& Other) = delete;
+
+	/** @return whether task has finished executing */
+	FORCEINLINE bool IsDone() const { return Handle && Handle.done(); }
+	/** @return whether task is waiting to be resumed by automation world */
+	FORCEINLINE bool IsSuspended() const { return Handle && !Handle.done() && Handle.promise().Scheduler != nullptr; }
+
+private:
+	explicit FWorldTask(std::coroutine_handle<promise_type> InHandle)
+		: Handle(InHandle)
+	{}
+
+	void Release();
+
+	std::coroutine_handle<promise_type> Handle;
+};
+
+/** Condition to resume suspended world task */
+struct FWorldTaskWaitCondition
+{
+	enum class EType: uint8
+	{
+		Frames,
+		Seconds,
+		Predicate
+	};
+
+	EType Type = EType::Frames;
+	/** number of frames or seconds to wait */
+	double Amount = 0.0;
+	/** predicate to wait on */
+	TFunction<bool()> Predicate;
+};
+
+/** Awaitable returned by FAutomationWorld::Frames, Seconds, Until and Loaded */
+struct COMMONAUTOMATION_API FWorldTaskAwaiter
+{
+	FWorldTaskAwaiter(FWorldTaskScheduler& InScheduler, FWorldTaskWaitCondition&& InCondition)
+		: Scheduler(InScheduler)
+		, Condition(MoveTemp(InCondition))
+	{}
+	
+	bool await_ready() const;
+	void await_suspend(std::coroutine_handle<FWorldTask::promise_type> Handle);
+	void await_resume() const {}
+
+	FWorldTaskScheduler& Scheduler;
+	FWorldTaskWaitCondition Condition;
+};
+
+/**
+ * Keeps suspended world tasks and resumes them from automation world tick loop.
+ * Frame and time waits are kept in heaps ordered by wake up time, so only tasks ready to resume are touched every frame.
+ * Predicate waits are evaluated once per frame.
+ * Tasks are resumed in the order they became ready: frame waits, time waits, then predicate waits.
+ */
+class COMMONAUTOMATION_API FWorldTaskScheduler
+{
+public:
+	FWorldTaskScheduler() = default;
+	~FWorldTaskScheduler();
+
+	/** suspend task until condition is met */
+	void Suspend(std::coroutine_handle<FWorldTask::promise_type> Handle, FWorldTaskWaitCondition&& Condition);
+	/** remove suspended task without resuming it */
+	void Cancel(std::coroutine_handle<FWorldTask::promise_type> Handle);
+	/** resume tasks that are ready after a frame has been ticked */
+	void ProcessFrame(uint64 InFrameIndex, double InWorldTime);
+
+	FORCEINLINE bool HasPendingTasks() const { return !FrameWaits.IsEmpty() || !TimeWaits.IsEmpty() || !PredicateWaits.IsEmpty(); }
+	FORCEINLINE uint64 GetFrameIndex() const { return FrameIndex; }
+	FORCEINLINE double GetWorldTime() const { return WorldTime; }
+
+private:
+	template <typename TKey>
+	struct TScheduledWait
+	{
+		TKey WakeUp;
+		std::coroutine_handle<FWorldTask::promise_type> Handle;
+
+		bool operator<(const TScheduledWait& Other) const { return WakeUp < Other.WakeUp; }
+	};
+
+	struct FPredicateWait
+	{
+		TFunction<bool()> Predicate;
+		std::coroutine_handle<FWorldTask::promise_type> Handle;
+	};
+
+	void Resume(std::coroutine_handle<FWorldTask::promise_type> Handle);
+
+	TArray<TScheduledWait<uint64>> FrameWaits;
+	TArray<TScheduledWait<double>> TimeWaits;
+	TArray<FPredicateWait> PredicateWaits;
+	/** frame addresses of tasks that are ready but not yet resumed this frame. Resumed task may cancel a ready sibling */
+	TSet<void*> ReadyTasks;
+	/** number of frames ticked by the owning automation world */
+	uint64 FrameIndex = 0;
+	/** simulated time accumulated by the owning automation world */
+	double WorldTime = 0.0;
+};
+	
+}
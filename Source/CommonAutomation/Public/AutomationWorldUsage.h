@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AutomationWorld.h"
+
+class UWorld;
+
+namespace UE::Automation
+{
+
+/** Engine systems observed to be used by automation world */
+enum class EWorldUsage: uint32
+{
+	None				= 0,
+	ScenePrimitives		= 1 << 0,	// primitive components with render representation
+	Collision			= 1 << 1,	// primitive components with query collision
+	PhysicsSimulation	= 1 << 2,	// primitive components that simulate physics
+	Navigation			= 1 << 3,	// navigation data or navigation bounds
+	AI					= 1 << 4,	// pawns possessed by non-player controllers
+	Audio				= 1 << 5,	// active or auto activated audio components
+	FX					= 1 << 6,	// active FX system components
+	GameInstance		= 1 << 7,	// game mode other than default, or explicitly enabled game instance subsystems
+	LocalPlayer			= 1 << 8,	// local player controller possesses a pawn, or explicitly enabled local player subsystems
+};
+ENUM_CLASS_FLAGS(EWorldUsage)
+
+/**
+ * Observes automation world state during its lifetime and recommends minimal init flags and subsystems for it.
+ * Usage is derived from world contents (components, actors, controllers), sampled after every TickWorld call.
+ * Subsystems count as used only when they are accessed through FAutomationWorld::GetSubsystem or GetOrCreateSubsystem,
+ * access through engine getters is not observed. Access to engine systems is not observed directly either, so recommendation is a lower bound to start from.
+ */
+class COMMONAUTOMATION_API FWorldUsageProbe
+{
+public:
+	/** @InitParams init params automation world was created with */
+	explicit FWorldUsageProbe(const FAutomationWorldInitParams& InitParams);
+
+	/** accumulate usage observed in @World */
+	void Sample(UWorld* World);
+	/** mark @SubsystemClass as used */
+	void NotifySubsystemAccessed(const UClass* SubsystemClass);
+
+	FORCEINLINE EWorldUsage GetUsage() const { return Usage; }
+	FORCEINLINE EWorldInitFlags GetRequestedFlags() const { return RequestedFlags; }
+	/** @return minimal init flags for observed usage */
+	EWorldInitFlags GetRecommendedFlags() const;
+	/** @return requested flags that observed usage doesn't need */
+	EWorldInitFlags GetUnusedFlags() const;
+	/** @return subsystems enabled by init params that were never accessed */
+	TArray<UClass*> GetUnusedSubsystems() const;
+	/** @return init params expression with recommended flags and used subsystems, ready to paste into the test */
+	FString GetSuggestedInitParams() const;
+
+	/** @return minimal init flags for @InUsage. Flags that are not derived from usage are taken from @InRequestedFlags */
+	static EWorldInitFlags RecommendFlags(EWorldUsage InUsage, EWorldInitFlags InRequestedFlags);
+	/** @return human-readable flag list */
+	static FString FlagsToString(EWorldInitFlags Flags);
+	/** @return flags as a C++ expression, e.g. EWorldInitFlags::InitScene | EWorldInitFlags::StartPlay */
+	static FString FlagsToCode(EWorldInitFlags Flags);
+
+private:
+	/** @return flag names set in @Flags */
+	static TArray<const TCHAR*> GetFlagNames(EWorldInitFlags Flags);
+	
+	EWorldUsage Usage = EWorldUsage::None;
+	EWorldInitFlags RequestedFlags = EWorldInitFlags::None;
+	TEnumAsByte<EWorldType::Type> RequestedWorldType = EWorldType::Game;
+	/** subsystems explicitly enabled by init params */
+	TArray<UClass*> RequestedSubsystems;
+	/** subsystems accessed through automation world */
+	TSet<const UClass*> AccessedSubsystems;
+	/** default game mode from init params */
+	TSubclassOf<AGameModeBase> RequestedGameMode;
+};
+
+}
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Engine/DeveloperSettings.h"
+#include "Modules/ModuleManager.h"
 
 #include "CommonAutomationSettings.generated.h"
 
@@ -18,6 +19,7 @@ struct FSubsystemContainer
 	FSubsystemContainer(UClass* InBaseType);
 
 	FORCEINLINE bool Initialized() const { return BaseType != nullptr; }
+	FORCEINLINE UClass* GetBaseType() const { return BaseType; }
 
 	FORCEINLINE void MarkDirty() const
 	{
@@ -30,6 +32,12 @@ struct FSubsystemContainer
 		return bDirty;
 	}
 
+	/** @return whether @Class is a concrete subsystem class of container's base type */
+	bool IsSubsystemClass(const UClass* Class) const;
+
+	/** add subsystem class to the container, keeping subsystem list sorted. @return false if class is already present */
+	bool AddSubsystem(UClass* SubsystemClass, bool bProjectModuleClass);
+
 	template <typename TSubsystemType>
 	const TArray<UClass*>& GetDisabledSubsystems(const TArray<TSubclassOf<TSubsystemType>>& EnabledSubsystems) const
 	{
@@ -60,12 +68,17 @@ struct FSubsystemContainer
 
 	TArray<UClass*> AllSubsystems;
 	TArray<UClass*> ProjectModuleSubsystems;
+	/** set if enabled subsystem list was initialized from defaults and not from config, meaning new subsystems should be enabled as well */
+	bool bDefaultEnabledSubsystems = false;
 
 private:
 	UClass* BaseType = nullptr;
 	mutable TArray<UClass*> DisabledSubsystems;
 	mutable bool bDirty = true;
 };
+
+/** @return module name for a native class, extracted from its /Script/<Module> package. NAME_None for non-native classes */
+COMMONAUTOMATION_API FName GetClassModuleName(const UClass* Class);
 	
 }
 
@@ -83,12 +96,15 @@ public:
 	static UCommonAutomationSettings* GetMutable();
 
 	virtual void PostInitProperties() override;
+	virtual void BeginDestroy() override;
 #if WITH_EDITOR
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
 #endif
 
-	static const TArray<FName>& GetProjectModules();
-    static bool IsProjectModuleClass(UClass* Class);
+	/** @return a set of game and game plugin modules */
+	static const TSet<FName>& GetProjectModules();
+	/** @return whether class is defined in one of project modules, derived from class's /Script/<Module> package */
+	static bool IsProjectModuleClass(const UClass* Class);
 
 	/** @return a list of disabled subsystems for each subsystem group: UWorldSubsystem, UGameInstanceSubsystem, ULocalPlayerSubsystem */
 	template <typename TSubsystemType>
@@ -118,6 +134,13 @@ public:
 	UPROPERTY(EditAnywhere, Config, meta = (Validate, EditCondition = "!bUseProjectDefaultGameMode"))
 	TSubclassOf<AGameModeBase> DefaultGameMode;
 
+	/**
+	 * Asset classes replaced with empty stubs when world is loaded with StubAssets flag, including derived classes
+	 * Classes from modules that are not loaded are ignored
+	 */
+	UPROPERTY(EditAnywhere, Config, meta = (NoElementDuplicate))
+	TArray<FSoftClassPath> StubAssetClasses;
+
 protected:
 
 	/**
@@ -152,16 +175,13 @@ protected:
 	void InitializeToDefault(UE::Automation::FSubsystemContainer& Container, TArray<TSubclassOf<TSubsystemType>>& EnabledArray, const FString& ConfigKey) const
 	{
 		static const TCHAR* ConfigSection{TEXT("/Script/CommonAutomation.CommonAutomationSettings")};
-
-		if (!Container.Initialized())
-		{
-			Container = UE::Automation::FSubsystemContainer{TSubsystemType::StaticClass()};
-		}
+		check(Container.Initialized());
 
 		FString ConfigArray{};
 		const bool bResult = GConfig->GetString(ConfigSection, *ConfigKey, ConfigArray, GEditorIni);
 
-		if (bResult == false || ConfigArray.IsEmpty())
+		Container.bDefaultEnabledSubsystems = bResult == false || ConfigArray.IsEmpty();
+		if (Container.bDefaultEnabledSubsystems)
 		{
 			EnabledArray.Reset();
 			EnabledArray = TArray<TSubclassOf<TSubsystemType>>{Container.AllSubsystems};
@@ -178,6 +198,33 @@ protected:
 		}
 	}
 
+	/** add subsystem classes from a newly loaded module to subsystem containers. Enabled by default if container was initialized to default */
+	template <typename TSubsystemType>
+	void AddModuleSubsystems(UE::Automation::FSubsystemContainer& Container, TArray<TSubclassOf<TSubsystemType>>& EnabledArray, TConstArrayView<UClass*> ModuleClasses)
+	{
+		for (UClass* Class: ModuleClasses)
+		{
+			if (!Container.IsSubsystemClass(Class))
+			{
+				continue;
+			}
+
+			const bool bProjectModuleClass = IsProjectModuleClass(Class);
+			if (Container.AddSubsystem(Class, bProjectModuleClass) && Container.bDefaultEnabledSubsystems)
+			{
+				if (!bProjectModuleClass || !bDisableProjectSubsystems)
+				{
+					EnabledArray.AddUnique(Class);
+				}
+			}
+		}
+	}
+
+	/** initialize subsystem containers by scanning derived classes of each subsystem type */
+	void InitializeSubsystemContainers();
+	/** pick up subsystems from modules loaded after engine initialization */
+	void HandleModulesChanged(FName ModuleName, EModuleChangeReason Reason);
+
 	/** @return config key name for each subsystem group: UWorldSubsystem, UGameInstanceSubsystem, ULocalPlayerSubsystem */
 	template <typename TSubsystemType>
 	FString GetConfigKey() const = delete;
@@ -185,4 +232,6 @@ protected:
 	UE::Automation::FSubsystemContainer WorldSubsystemContainer;
 	UE::Automation::FSubsystemContainer GameInstanceSubsystemContainer;
 	UE::Automation::FSubsystemContainer LocalPlayerSubsystemContainer;
+
+	FDelegateHandle ModulesChangedHandle;
 };